@@ -0,0 +1,10 @@
+// Per-frame camera data shared by every program (FrameUniformData in FrameUniforms.h)
+layout(std140) uniform FrameUniforms {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec4 fogColor; // Fog for passes that apply it: rgb, a = strength
+    vec4 fogRange; // x = start distance, y = full distance
+    vec4 time;     // x = seconds
+};
@@ -0,0 +1,35 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoord;
+layout(location = 3) in float aLayerIndex;
+layout(location = 4) in mat4 aInstanceModel;  // Per-instance transform (uses locations 4-7)
+layout(location = 8) in float aInstanceLayer; // Per-instance texture layer, -1 keeps the mesh's layers
+
+out vec3 vNormal;
+out vec2 vTexCoord;
+flat out float vLayerIndex;
+#ifdef FOG
+out vec3 vWorldPosition; // Fog fades by distance from the camera
+#endif
+
+#include "frame_uniforms.glsl"
+
+void main() {
+    vec4 worldPosition = aInstanceModel * vec4(aPos, 1.0);
+    gl_Position = viewProjection * worldPosition;
+
+    // Instances are translated and scaled per axis, never rotated (buildEntityInstances).
+    // The cube's normals are axis-aligned, and an axis-aligned scale only changes their
+    // length, so mat3(model) plus normalize gives the right direction without an inverse-
+    // transpose. Rotation combined with non-uniform scale breaks this: instances would then
+    // need a normal matrix (inverse-transpose of the model matrix) computed on the CPU.
+    vNormal = normalize(mat3(aInstanceModel) * aNormal);
+
+    vTexCoord = aTexCoord;
+    vLayerIndex = aInstanceLayer >= 0.0 ? aInstanceLayer : aLayerIndex;
+#ifdef FOG
+    vWorldPosition = worldPosition.xyz;
+#endif
+}
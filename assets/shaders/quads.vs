@@ -0,0 +1,53 @@
+#version 330 core
+
+// Vertex pulling: no vertex attributes. Every block face is one RG32UI texel in 'quads'
+// (see PackedQuad in MeshData.h), drawn with the shared quad index buffer so that
+// gl_VertexID = quad * 4 + corner.
+
+uniform usamplerBuffer quads;
+
+out vec3 vNormal;
+out vec2 vTexCoord;
+flat out float vLayerIndex;
+#ifdef FOG
+out vec3 vWorldPosition; // Fog fades by distance from the camera
+#endif
+
+#include "frame_uniforms.glsl"
+
+// Corners of each face on a unit cube from its minimum corner, CCW from outside.
+// Same face and corner order as MeshBuilder::appendCube.
+const vec3 corners[24] = vec3[](
+    vec3(0, 0, 1), vec3(1, 0, 1), vec3(1, 1, 1), vec3(0, 1, 1), // Front (+Z)
+    vec3(1, 0, 0), vec3(0, 0, 0), vec3(0, 1, 0), vec3(1, 1, 0), // Back (-Z)
+    vec3(1, 0, 1), vec3(1, 0, 0), vec3(1, 1, 0), vec3(1, 1, 1), // Right (+X)
+    vec3(0, 0, 0), vec3(0, 0, 1), vec3(0, 1, 1), vec3(0, 1, 0), // Left (-X)
+    vec3(0, 1, 1), vec3(1, 1, 1), vec3(1, 1, 0), vec3(0, 1, 0), // Top (+Y)
+    vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 0, 1), vec3(0, 0, 1)  // Bottom (-Y)
+);
+
+const vec3 normals[6] = vec3[](
+    vec3(0, 0, 1), vec3(0, 0, -1), vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0)
+);
+
+const vec2 uvs[4] = vec2[](vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1));
+
+void main() {
+    int quad = gl_VertexID >> 2;
+    int corner = gl_VertexID & 3;
+    uvec2 record = texelFetch(quads, quad).xy;
+
+    vec3 cellMin = vec3(record.x & 1023u, (record.x >> 10) & 1023u, (record.x >> 20) & 1023u);
+    int face = int(record.y & 7u);
+    float size = float(1u << ((record.y >> 3) & 7u));
+
+    vec3 position = cellMin + corners[face * 4 + corner] * size;
+    gl_Position = viewProjection * vec4(position, 1.0); // Chunks are built in world space
+
+    vNormal = normals[face];
+    vTexCoord = uvs[corner] * size; // Texture repeats once per block, like appendCube
+    vLayerIndex = float(record.y >> 8);
+#ifdef FOG
+    vWorldPosition = position;
+#endif
+}
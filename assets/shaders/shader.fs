@@ -1,18 +1,44 @@
 #version 330 core
 
+// Variants (defines injected by Shader, chosen per frame by Application):
+//   FOG                 blends towards fogColor between fogRange.x and fogRange.y
+//   DEBUG_VIEW_NORMALS  shows the normal as a color instead of the texture
+//   DEBUG_VIEW_LAYERS   shows the texture array layer as a color
+// Each combination is its own program, so no feature costs a branch when it is off.
+
 in vec3 vNormal;        // Received from vertex shader (for potential lighting later)
 in vec2 vTexCoord;      // Received interpolated texture coordinates from vertex shader
 flat in float vLayerIndex; // Receive layer index (flat)
+#ifdef FOG
+in vec3 vWorldPosition;
+#endif
 
 out vec4 FragColor;     // Output color for the current pixel
 
 uniform sampler2DArray textureSampler; // Use sampler2DArray
+#include "frame_uniforms.glsl"
 
 void main() {
+#if defined(DEBUG_VIEW_NORMALS)
+    FragColor = vec4(normalize(vNormal) * 0.5 + 0.5, 1.0);
+#elif defined(DEBUG_VIEW_LAYERS)
+    // Distinct, stable color per layer
+    FragColor = vec4(fract(vLayerIndex * vec3(0.318, 0.547, 0.771)) * 0.75 + 0.25, 1.0);
+#else
     // Sample using 3D coordinate (U, V, Layer)
     vec4 textureColor = texture(textureSampler, vec3(vTexCoord, vLayerIndex));
+    // Cutout textures (leaves): the mips keep their coverage at this threshold (TextureArrayBuilder)
+    if (textureColor.a < 0.5)
+        discard;
 
     // Optional lighting...
     // FragColor = textureColor * lightingFactor;
     FragColor = textureColor;
-}
\ No newline at end of file
+#endif
+
+#ifdef FOG
+    float distance = length(vWorldPosition - cameraPosition.xyz);
+    float fog = clamp((distance - fogRange.x) / (fogRange.y - fogRange.x), 0.0, 1.0) * fogColor.a;
+    FragColor.rgb = mix(FragColor.rgb, fogColor.rgb, fog);
+#endif
+}
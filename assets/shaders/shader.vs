@@ -1,27 +1,63 @@
 #version 330 core
 
 layout(location = 0) in vec3 aPos;
+#ifdef PACKED_NORMAL
+layout(location = 1) in uint aNormal; // Signed bytes x, y, z (PackedVertex::packNormal)
+#else
 layout(location = 1) in vec3 aNormal;
+#endif
 layout(location = 2) in vec2 aTexCoord; // Input texture coordinates
 layout(location = 3) in float aLayerIndex; // New attribute
 
 out vec3 vNormal;       // Pass normal to fragment shader
 out vec2 vTexCoord;     // Pass texture coordinates to fragment shader
 flat out float vLayerIndex; // New output (use 'flat'!)
+#ifdef FOG
+out vec3 vWorldPosition; // Fog fades by distance from the camera
+#endif
 
+// Variants (defines injected by Shader):
+//   IDENTITY_MODEL  geometry is already in world space (chunk meshes): no model transform,
+//                   and the axis-aligned unit normals pass through unchanged
+//   PACKED_NORMAL   the normal arrives packed into one uint (chunk meshes, 28-byte vertices)
+//   FOG             also outputs the world position for the fog in shader.fs
+#ifndef IDENTITY_MODEL
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix; // Inverse-transpose of 'model', computed once per draw on the CPU
+#endif
+#include "frame_uniforms.glsl"
+
+#ifdef PACKED_NORMAL
+vec3 unpackNormal(uint bits) {
+    // Move each byte to the top and shift back down to sign-extend it
+    ivec3 bytes = ivec3(int(bits << 24u), int(bits << 16u), int(bits << 8u)) >> 24;
+    return vec3(bytes) / 127.0;
+}
+#else
+vec3 unpackNormal(vec3 normal) {
+    return normal;
+}
+#endif
 
 void main() {
+#ifdef IDENTITY_MODEL
+    vec4 worldPosition = vec4(aPos, 1.0);
+    gl_Position = viewProjection * worldPosition;
+    vNormal = unpackNormal(aNormal);
+#else
     // Standard Model-View-Projection transformation
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec4 worldPosition = model * vec4(aPos, 1.0);
+    gl_Position = viewProjection * worldPosition;
 
-    // Calculate world-space normal for lighting (if needed later)
-    // Use the normal matrix to handle non-uniform scaling correctly
-    vNormal = normalize(mat3(transpose(inverse(model))) * aNormal); // Corrected normal calc
+    // World-space normal for lighting (if needed later); the normal matrix handles
+    // non-uniform scaling correctly
+    vNormal = normalize(normalMatrix * unpackNormal(aNormal));
+#endif
 
     // Pass the texture coordinate directly to the fragment shader
     vTexCoord = aTexCoord;
     vLayerIndex = aLayerIndex; // Pass layer index through
+#ifdef FOG
+    vWorldPosition = worldPosition.xyz;
+#endif
 }
\ No newline at end of file
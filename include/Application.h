@@ -4,24 +4,47 @@
 #include <memory> // For unique_ptr
 #include "World.h"
 #include "Camera.h"
+#include "Player.h"
+#include "EntityManager.h"
+#include "InstanceBuffer.h"
+#include "MeshData.h"
+#include "FrameStats.h"
+#include "InputRecording.h"
+#include "MainThreadQueue.h"
+#include "ShaderVariants.h"
+#include <string>
 #include <map>
+#include <vector>
+#include <ostream>
 // Forward declarations to avoid including heavy headers
 class Window;
 class Shader;
 class Mesh;
 class Renderer;
-
-struct InputState
+class GpuTimer;
+class HeadlessContext;
+class SoftwareRenderer;
+class JobSystem;
+class QuadIndexBuffer;
+class QuadMesh;
+class ShaderWatcher;
+
+// Command line options (see main.cpp)
+struct AppConfig
 {
-    bool forward = false;
-    bool backward = false;
-    bool left = false;
-    bool right = false;
-    bool up = false;
-    bool down = false;
-
-    float mouseDX = 0.0f; // mouse delta x
-    float mouseDY = 0.0f; // mouse delta y
+    std::string recordInputPath;               // Record every frame's input to this file when set
+    std::string replayInputPath;               // Drive the app from a recording instead of the keyboard and mouse when set
+    std::string frameStatsPath = "frame_stats.csv"; // Frame stats sink (.json for JSON Lines)
+    std::string shaderCacheDir = "shader_cache";    // Linked program binaries from earlier runs ('' disables)
+    bool headless = false;                     // Render offscreen through EGL instead of opening a window
+    int maxFrames = 0;                         // Exit after this many frames (0 = run until closed)
+    bool softwareRenderer = false;             // Rasterize on the CPU (SoftwareRenderer) and only blit the result with GL
+    bool vertexPulling = false;                // Draw chunks from per-face quad records (QuadMesh) instead of vertex buffers
+    bool watchShaders = true;                  // Recompile shaders when their files change
+    std::string goldenDir;                     // Render the golden-image cases and compare them against this directory when set
+    bool updateGolden = false;                 // Overwrite the goldens (and stored timings) instead of comparing
+    float lodDistance = 16.0f;                 // Chunks closer than this (blocks) get full detail; each further LOD doubles it
+    std::vector<double> hitchThresholdsMs;     // Frame times (ms) counted as hitches (empty keeps FrameStats' 33.3/50/100)
 };
 
 struct FaceToLayer
@@ -34,10 +57,33 @@ struct FaceToLayer
     int right;
 };
 
+// A chunk picked for re-meshing and what it is rebuilt as
+struct ChunkRebuild
+{
+    size_t chunkIndex = 0;
+    glm::ivec3 coords = glm::ivec3(0); // Chunk grid coordinates
+    int lod = 0;
+    bool edited = false; // Blocks changed (rather than only the LOD)
+};
+
+// GPU mesh of one world chunk and the level of detail it was built at
+struct ChunkMesh
+{
+    std::unique_ptr<Mesh> mesh; // null when the chunk is empty
+    std::unique_ptr<QuadMesh> quadMesh; // Replaces 'mesh' with --vertex-pulling
+    MeshData cpuMesh;           // Kept instead of 'mesh' when the software renderer is used
+    // GPU-layout geometry waiting for the main thread to upload it. Written by a meshing job,
+    // read by the upload task; the two never overlap because tasks are not drained while
+    // meshing jobs run. Capacity is kept, so re-meshing does not allocate.
+    std::vector<PackedVertex> stagingVertices;
+    std::vector<PackedQuad> stagingQuads; // Same, for the vertex-pulling path
+    int lod = -1;               // -1 until the chunk has been meshed
+};
+
 class Application
 {
 public:
-    Application();
+    explicit Application(const AppConfig &config = AppConfig());
     ~Application();
 
     // Prevent copying/assignment
@@ -50,20 +96,75 @@ public:
     // Run the main application loop
     void run();
 
+    // Renders every golden-image case (GoldenImages.h) offscreen and compares it with the stored
+    // PNG, or rewrites the PNGs with config.updateGolden. Returns false on any mismatch.
+    bool runGoldenImages();
+
 private:
+    AppConfig config_;
+
     // Core components
+    std::unique_ptr<JobSystem> jobs_; // Worker threads shared by meshing and the software renderer
     std::unique_ptr<Window> window_;
-    std::unique_ptr<Shader> blockShader_;
-    std::unique_ptr<Mesh> worldMesh_;
+    std::unique_ptr<HeadlessContext> headless_; // Replaces window_ in headless mode
+    ShaderVariants shaderVariants_; // Owns every program; the pointers below are the variants in use
+    Shader *blockShader_ = nullptr;
+    Shader *quadShader_ = nullptr; // Vertex-pulling chunk shader (--vertex-pulling only)
+    enum class DebugView
+    {
+        None,
+        Normals, // DEBUG_VIEW_NORMALS
+        Layers,  // DEBUG_VIEW_LAYERS
+        Count
+    };
+    DebugView debugView_ = DebugView::None; // Cycled with F3, picks the shader variants above
     std::unique_ptr<Renderer> renderer_;
+
+    // World geometry, one mesh per chunk (indexed like World's chunk grid)
+    std::vector<ChunkMesh> chunkMeshes_;
+    std::unique_ptr<QuadIndexBuffer> quadIndices_; // Index buffer every chunk mesh draws with
+    std::vector<const Mesh *> chunkDrawList_; // Rebuilt every frame, kept to reuse its allocation
+    std::vector<const QuadMesh *> quadDrawList_; // Same, for the vertex-pulling path
+    std::vector<ChunkRebuild> chunkRebuilds_; // Chunks being re-meshed this frame
+    std::vector<std::unique_ptr<Arena>> meshArenas_; // Per job thread: temporaries of one chunk rebuild (reset every frame)
+    float lodBaseDistance_ = 0.0f;            // config_.lodDistance, or a golden case's own distance
+    std::vector<uint64_t> chunkRebuildsPerLod_; // Re-meshes per LOD since the last reportChunkRebuilds()
+
+    // Entities are drawn as instances of one cube mesh
+    Shader *entityShader_ = nullptr;
+    std::unique_ptr<Mesh> entityMesh_;
+    std::unique_ptr<InstanceBuffer> entityInstances_;
+    std::vector<InstanceData> entityInstanceData_; // Rebuilt every frame, kept to reuse its allocation
+    MeshData entityMeshData_;                      // CPU copy of the entity cube for the software renderer
+
+    // CPU rasterizer backend; its image is uploaded to a texture and blitted to the screen
+    std::unique_ptr<SoftwareRenderer> softwareRenderer_;
+    std::vector<const MeshData *> softwareDrawList_;
+    unsigned int softwareFrameTexture_ = 0;
+    unsigned int softwareFrameFbo_ = 0;
+    int framebufferWidth_ = 800;
+    int framebufferHeight_ = 600;
     World gameWorld_;
     Camera camera_;
-
-    unsigned int blockTextureArrayId;
+    double simulationTime_ = 0.0; // Seconds of fixed update ticks run so far (frame uniform 'time')
+    // Distance fog published in the frame uniforms (alpha = strength, range = start/full distance).
+    // Only the FOG shader variants apply it (F4).
+    glm::vec4 fogColor_ = glm::vec4(0.2f, 0.3f, 0.3f, 1.0f);
+    glm::vec2 fogRange_ = glm::vec2(64.0f, 128.0f);
+    bool fogEnabled_ = false;
+    Player player_;
+    EntityManager entities_;
+
+    unsigned int blockTextureArrayId = 0;
     std::map<BlockType, FaceToLayer> layer_mapping;
 
     InputState input_;
-    float cameraSpeed_ = 5.0f; // movement speed
+    std::unique_ptr<InputRecorder> inputRecorder_;  // Set when recording
+    std::unique_ptr<InputPlayback> inputPlayback_;  // Set when replaying
+    bool flyKeyWasDown_ = false;   // for edge-detecting the fly toggle
+    bool traceKeyWasDown_ = false; // for edge-detecting the trace dump key
+    bool debugViewKeyWasDown_ = false;
+    bool fogKeyWasDown_ = false;
     float mouseSens_ = 0.1f;   // look sensitivity
     float yaw_ = 0.0f;
     float pitch_ = 0.0f;
@@ -71,20 +172,34 @@ private:
     double lastX_ = 400.0; // center of 800×600 window
     double lastY_ = 300.0;
 
-    int frameCount_ = 0;
-    float totalTime_ = 0.0f;          // Accumulates delta time
-    float timeSinceLastPrint_ = 0.0f; // Time since the last FPS was printed
+    MainThreadQueue mainThreadTasks_;       // GL work (chunk uploads) drained once per frame within a time budget
+    std::unique_ptr<ShaderWatcher> shaderWatcher_; // Reports edited shader files (hot reload)
+
+    FrameStats frameStats_;                 // Frame time percentiles, reported every 5 seconds
+    std::unique_ptr<GpuTimer> gpuFrameTimer_; // GPU time of the render stage
 
     // Private helper methods for initialization steps
     bool initWindow();
     bool initOpenGL(); // For GL settings like depth test
     bool loadResources();
     void setupScene();
+    void reloadChangedShaders(); // Starts recompiling edited shaders and swaps in finished ones
+    bool selectShaderVariants(); // Points blockShader_ & co. at the variants for fogEnabled_ and debugView_
+    bool updateChunkMeshes();                                // Re-meshes chunks that were edited or changed LOD
+    void reportChunkRebuilds(std::ostream &out, const std::string &label); // Prints and resets chunkRebuildsPerLod_
+    void rebuildChunkMesh(const ChunkRebuild &rebuild, Arena &arena); // Runs on job threads
+    int selectChunkLod(int cx, int cy, int cz, int currentLod) const; // LOD for a chunk from its distance to the camera
 
     // Main loop steps
+    bool shouldClose() const;
+    void presentFrame(); // Swaps the window buffers, or finishes the offscreen frame when headless
     void processInput();          // Placeholder for input handling
     void update(float deltaTime); // Placeholder for game logic updates
     void render();
+    void renderEntities(); // Uploads entity transforms and draws them all in one instanced call
+    void buildEntityInstances();
+    void renderSoftware(); // Rasterizes the frame on the CPU, then blits it to the framebuffer
+    bool initSoftwareRenderer();
 
     // Cleanup (mostly handled by destructors/RAII, but can be explicit if needed)
     void shutdown();
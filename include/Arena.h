@@ -0,0 +1,104 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Linear (bump) allocator for short-lived data such as per-frame and per-job temporaries.
+//
+// Allocating moves a pointer forward; nothing is freed individually. Memory comes back all at
+// once, either by rewinding to a marker (ArenaScope, for data that lives as long as one job)
+// or by reset() (for data that lives one frame). Blocks are kept between uses, and reset()
+// merges them into one block covering the high-water mark, so an arena whose workload
+// repeats stops touching the heap after the first few frames.
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 256 * 1024);
+    ~Arena();
+
+    // Prevent copying/assignment (allocations point into the blocks)
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    // Only reclaims memory if this was the newest allocation (e.g. a vector growing at the top)
+    void deallocate(void *pointer, size_t size);
+
+    struct Marker
+    {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+    Marker mark() const { return Marker{current_, offset_}; }
+    // Frees everything allocated after 'marker' was taken
+    void rewind(const Marker &marker);
+    // Frees everything; see the class comment for how blocks are kept
+    void reset();
+
+    size_t bytesUsed() const;
+    size_t capacity() const;
+    size_t peakBytes() const { return peakBytes_; }
+    size_t blockAllocations() const { return blockAllocations_; } // Heap allocations made so far
+
+private:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size = 0;
+    };
+
+    size_t blockSize_;
+    std::vector<Block> blocks_;
+    size_t current_ = 0; // Block being allocated from
+    size_t offset_ = 0;  // First free byte in that block
+    size_t peakBytes_ = 0;
+    size_t blockAllocations_ = 0;
+
+    void addBlock(size_t minimumSize);
+};
+
+// Rewinds an arena to where it was when the scope started (per-job lifetime)
+class ArenaScope
+{
+public:
+    explicit ArenaScope(Arena &arena) : arena_(arena), marker_(arena.mark()) {}
+    ~ArenaScope() { arena_.rewind(marker_); }
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+    Arena &arena_;
+    Arena::Marker marker_;
+};
+
+// Standard allocator interface over an Arena, for std::vector and friends.
+// Containers using it must not outlive the arena scope they were created in.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena &arena) noexcept : arena_(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena_(other.arena()) {}
+
+    T *allocate(size_t count) { return static_cast<T *>(arena_->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T *pointer, size_t count) noexcept { arena_->deallocate(pointer, count * sizeof(T)); }
+
+    Arena *arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena_ == other.arena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena_ != other.arena(); }
+
+private:
+    Arena *arena_;
+};
+
+#endif // ARENA_H
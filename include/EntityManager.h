@@ -0,0 +1,88 @@
+#ifndef ENTITY_MANAGER_H
+#define ENTITY_MANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "World.h"
+
+// Handle to an entity: low 24 bits are the slot index, high 8 bits a generation counter
+// so stale handles to destroyed entities are detected instead of aliasing a new one.
+// A slot is retired after 255 entities instead of letting its generation wrap around.
+using Entity = uint32_t;
+const Entity INVALID_ENTITY = 0xFFFFFFFFu;
+
+enum class EntityKind : uint8_t
+{
+    MOB = 0,
+    DROPPED_ITEM = 1,
+    PROJECTILE = 2,
+};
+
+// Component storage in structure-of-arrays form. Index i in every array belongs to the
+// same entity, and the arrays are kept densely packed (no holes) so systems can run
+// straight, vectorizable loops over them.
+struct EntityComponents
+{
+    // Position (center of the bounding box)
+    std::vector<float> posX, posY, posZ;
+    // Velocity in blocks per second
+    std::vector<float> velX, velY, velZ;
+    // Bounding box half extents (collision and drawing)
+    std::vector<float> halfX, halfY, halfZ;
+    // Multiplier on gravity: 1 for falling objects, 0 for hovering ones
+    std::vector<float> gravityScale;
+    // Non-zero if solid voxels stop the entity (below its footprint or in its way sideways)
+    std::vector<uint8_t> collides;
+    std::vector<EntityKind> kind;
+    // Block the entity is drawn as (dropped blocks), AIR for the default look
+    std::vector<BlockType> blockType;
+    // Owning entity of each dense slot (used to fix up the sparse set on removal)
+    std::vector<Entity> owner;
+
+    size_t size() const { return owner.size(); }
+};
+
+// Small entity-component system based on a sparse set: entity slot -> dense index.
+// Creation appends to the dense arrays and destruction swaps the last element into the
+// hole, so both are O(1) and iteration never touches dead entities.
+class EntityManager
+{
+public:
+    float gravity = 32.0f;
+    float groundFriction = 8.0f; // Horizontal velocity decay per second while resting on a block
+
+    Entity create(EntityKind kind, const glm::vec3 &position, const glm::vec3 &velocity, const glm::vec3 &halfExtents, float gravityScale = 1.0f, bool collides = true, BlockType blockType = BlockType::AIR);
+    void destroy(Entity entity);
+    bool isAlive(Entity entity) const;
+
+    size_t size() const { return components_.size(); }
+    void clear();
+
+    glm::vec3 getPosition(Entity entity) const;
+    void setVelocity(Entity entity, const glm::vec3 &velocity);
+
+    // Read-only access to the packed component arrays (e.g. for rendering)
+    const EntityComponents &components() const { return components_; }
+
+    // Runs every system once for a fixed simulation step
+    void update(const World &world, float dt);
+
+private:
+    EntityComponents components_;
+    std::vector<uint32_t> sparse_;     // slot index -> dense index
+    std::vector<uint8_t> generations_; // slot index -> current generation
+    std::vector<uint32_t> freeSlots_;  // recycled slot indices
+
+    // Per-tick scratch space for the collision systems
+    std::vector<int> cellX_, cellY_, cellZ_;
+    std::vector<int> cellX1_, cellZ1_; // Far corner of the footprint
+    std::vector<uint32_t> movingIndices_; // Entities moving horizontally this tick
+    std::vector<uint8_t> solid_;
+
+    // Returns the dense index of a live entity, or -1
+    long denseIndex(Entity entity) const;
+};
+
+#endif // ENTITY_MANAGER_H
@@ -0,0 +1,107 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Log-linear histogram of durations in microseconds, in the style of HdrHistogram:
+// values below 64us are exact, above that every power-of-two range is split into 32
+// equal buckets, so any recorded value is known to within ~3%. Fixed memory, O(1) record.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(uint64_t microseconds);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    // Value at the given percentile (0-100), in microseconds
+    uint64_t percentile(double percent) const;
+
+private:
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+};
+
+// Parts of a frame that are timed separately
+enum class FrameStage
+{
+    Input = 0,
+    Update,
+    Meshing,
+    Render,
+    Swap,
+    Count
+};
+
+// Render passes whose GPU time is measured separately (see Renderer)
+enum class GpuPass
+{
+    Clear = 0,
+    World,
+    Entities,
+    Count
+};
+
+// Timings for one frame, in milliseconds
+struct FrameTiming
+{
+    double cpuFrameMs = 0.0;
+    double gpuFrameMs = -1.0; // Negative when no GPU measurement is available
+    double stageMs[static_cast<int>(FrameStage::Count)] = {};
+    double gpuPassMs[static_cast<int>(GpuPass::Count)] = {-1.0, -1.0, -1.0}; // Negative like gpuFrameMs
+};
+static_assert(static_cast<int>(GpuPass::Count) == 3, "Update the gpuPassMs initializer");
+
+// Collects per-frame timings over a reporting interval and summarizes them as
+// percentiles and hitch counts. Summaries go to a stream (stdout) and optionally to a
+// CSV or JSON Lines file, one row/object per interval.
+class FrameStats
+{
+public:
+    FrameStats();
+
+    // A frame slower than each of these counts as a hitch (one counter per threshold).
+    // Call before the first report, the sink header names the thresholds.
+    void setHitchThresholds(const std::vector<double> &thresholdsMs);
+
+    void recordFrame(const FrameTiming &timing);
+
+    // Number of frames recorded in the current interval
+    uint64_t frameCount() const { return cpuFrame_.count(); }
+
+    // Opens a sink file; '.json' writes JSON Lines, anything else CSV. Returns false on failure.
+    bool openSink(const std::string &path);
+
+    // Prints the current interval's summary and appends it to the sink (if any)
+    void report(std::ostream &out, double intervalSeconds);
+
+    // Starts a new interval
+    void reset();
+
+private:
+    LatencyHistogram cpuFrame_;
+    LatencyHistogram gpuFrame_;
+    LatencyHistogram stages_[static_cast<int>(FrameStage::Count)];
+    LatencyHistogram gpuPasses_[static_cast<int>(GpuPass::Count)];
+    std::vector<double> hitchThresholdsMs_ = {33.3, 50.0, 100.0};
+    std::vector<uint64_t> hitchCounts_;
+
+    std::ofstream sink_;
+    bool sinkIsJson_ = false;
+    bool sinkHeaderWritten_ = false;
+    double elapsedSeconds_ = 0.0; // Time since stats started, stamped on every sink row
+
+    void writeCsvRow(double intervalSeconds);
+    void writeJsonLine(double intervalSeconds);
+    bool hasGpuPasses() const;
+};
+
+#endif // FRAME_STATS_H
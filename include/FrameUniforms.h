@@ -0,0 +1,44 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glm/glm.hpp>
+
+// Per-frame values every shader reads, laid out like the std140 'FrameUniforms' block in the
+// shaders (vec4 members only, so the C++ and GLSL layouts match without padding rules)
+struct FrameUniformData
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 cameraPosition; // xyz, w unused
+    glm::vec4 fogColor;       // rgb, a = fog strength, for passes that apply fog
+    glm::vec4 fogRange;       // x = distance fog starts, y = distance it is full, zw unused
+    glm::vec4 time;           // x = seconds of simulation time, yzw unused
+};
+static_assert(sizeof(FrameUniformData) == 3 * 64 + 4 * 16, "FrameUniformData must match the std140 block");
+
+// Uniform buffer holding FrameUniformData at a fixed binding point. Shader links every program
+// that declares the block to kBindingPoint, so one upload per frame reaches all programs and
+// passes instead of setting view/projection on each program separately.
+class FrameUniforms
+{
+public:
+    static const unsigned int kBindingPoint = 0;
+    static constexpr const char *kBlockName = "FrameUniforms";
+
+    FrameUniforms();
+    ~FrameUniforms();
+
+    // Prevent copying/assignment (owns a GL buffer)
+    FrameUniforms(const FrameUniforms &) = delete;
+    FrameUniforms &operator=(const FrameUniforms &) = delete;
+
+    // Replaces the contents. The buffer is orphaned by the mapping, so this never waits for
+    // draws of the previous frame that still read the old values.
+    void update(const FrameUniformData &data);
+
+private:
+    unsigned int UBO_ = 0;
+};
+
+#endif // FRAME_UNIFORMS_H
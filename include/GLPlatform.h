@@ -0,0 +1,20 @@
+#ifndef GL_PLATFORM_H
+#define GL_PLATFORM_H
+
+// Single place that pulls in the OpenGL 3.3 core API for the current platform.
+// Include this before <GLFW/glfw3.h>; GLFW is told not to add its own (legacy) GL header.
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+// Linux: link against libGL (glvnd), which exports the core entry points directly
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+#include <GL/glcorearb.h>
+#endif
+
+#ifndef GLFW_INCLUDE_NONE
+#define GLFW_INCLUDE_NONE
+#endif
+
+#endif // GL_PLATFORM_H
@@ -0,0 +1,53 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <cstdint>
+#include <ostream>
+
+// Shadow copy of the GL state the renderer changes most (program, VAO, texture and buffer
+// bindings, depth/cull/blend switches, clear color). Each setter compares against the copy
+// and skips the driver call when nothing would change, so draw code can simply state what it
+// needs instead of binding and unbinding around every draw.
+//
+// The copy is only right if every change goes through here: use these instead of the raw GL
+// calls on the main thread (the only thread with a context), and tell the cache about
+// deleted objects, since GL silently unbinds them and their names get reused.
+// Not cached: GL_ELEMENT_ARRAY_BUFFER (part of the bound VAO) and framebuffer bindings.
+namespace GLState
+{
+    void useProgram(unsigned int program);
+    void bindVertexArray(unsigned int vao);
+    // GL_ARRAY_BUFFER, GL_TEXTURE_BUFFER and GL_UNIFORM_BUFFER are cached, other targets pass through
+    void bindBuffer(unsigned int target, unsigned int buffer);
+    // glBindBufferBase also replaces the generic binding of 'target', so it goes through here too
+    void bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+    // Binds on texture unit 'unit' (0-based). GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY and
+    // GL_TEXTURE_BUFFER are cached, other targets pass through. Leaves 'unit' active.
+    void bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+    // GL_DEPTH_TEST, GL_CULL_FACE and GL_BLEND are cached, other capabilities pass through
+    void setEnabled(unsigned int capability, bool enabled);
+    void setClearColor(float r, float g, float b, float a);
+
+    // GL unbinds deleted objects; call these right after deleting so the copy follows
+    void programDeleted(unsigned int program);
+    void vertexArrayDeleted(unsigned int vao);
+    void bufferDeleted(unsigned int buffer);
+    void textureDeleted(unsigned int texture);
+
+    // Forgets everything (e.g. after a new context was made current); the next call of each
+    // setter goes to the driver
+    void invalidate();
+
+    // Calls made and skipped since the last resetStats()
+    struct Stats
+    {
+        uint64_t issued = 0;
+        uint64_t avoided = 0;
+    };
+    const Stats &getStats();
+    void resetStats();
+    // Prints the calls issued and avoided per frame over 'frames' frames
+    void reportStats(std::ostream &out, uint64_t frames);
+}
+
+#endif // GL_STATE_H
@@ -0,0 +1,69 @@
+#ifndef GOLDEN_IMAGES_H
+#define GOLDEN_IMAGES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class World;
+
+// Support code for the golden-image regression run (--golden / --update-golden):
+// fixed scenes and camera poses, PNG I/O, perceptual image comparison and the stored
+// frame timings each golden is checked against.
+namespace GoldenImages
+{
+    // 8-bit RGB image, top row first (PNG order)
+    struct RgbImage
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    enum class Scene
+    {
+        DEFAULT, // Application::setupScene
+        TERRAIN, // Rolling heightmap with a tree
+        STRESS,  // 3D checkerboard: every block face is exposed
+    };
+
+    struct Case
+    {
+        const char *name;
+        Scene scene;
+        glm::vec3 eye;
+        glm::vec3 target;
+        float lodDistance = 0.0f; // Replaces --lod-distance for this case when set (cases for the coarse LODs)
+    };
+
+    // Every case the suite renders, in order
+    const std::vector<Case> &cases();
+
+    // Scene builders for an empty world
+    void buildTerrainScene(World &world);
+    void buildStressScene(World &world);
+
+    bool writePng(const std::string &path, const RgbImage &image);
+    bool readPng(const std::string &path, RgbImage &image);
+
+    struct Difference
+    {
+        size_t differingPixels = 0; // Pixels whose perceptual difference exceeds the threshold
+        double differingPercent = 0.0;
+        double maxDelta = 0.0;      // Largest perceptual difference, 0 (same) to 1 (black vs white)
+    };
+
+    // Compares two images of the same size with a YIQ color distance, which weights
+    // brightness changes over hue changes roughly like the eye does.
+    // 'threshold' is the per-pixel distance (0-1) below which pixels count as equal.
+    Difference compareImages(const RgbImage &a, const RgbImage &b, double threshold);
+
+    // Median frame time per "case/backend" key, stored as CSV next to the goldens
+    std::map<std::string, double> readTimings(const std::string &path);
+    bool writeTimings(const std::string &path, const std::map<std::string, double> &timings);
+}
+
+#endif // GOLDEN_IMAGES_H
@@ -0,0 +1,39 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+// Measures GPU time of a span of GL commands with GL_TIME_ELAPSED queries.
+// Results arrive a few frames late, so a small ring of queries is kept in flight and
+// collect() only reads queries the driver reports as finished; it never stalls the CPU.
+class GpuTimer
+{
+public:
+    static const int kQueryCount = 4; // Frames of latency the ring can absorb
+
+    GpuTimer();
+    ~GpuTimer();
+
+    // Prevent copying/assignment (owns GL query objects)
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    // False if the context has no timer queries (GL < 3.3 without ARB_timer_query)
+    bool isSupported() const { return supported_; }
+
+    // Brackets the commands to time. Only one begin/end pair may be open at a time.
+    void begin();
+    void end();
+
+    // Milliseconds of the newest finished measurement, or -1 if none finished since the last call
+    double collect();
+
+private:
+    unsigned int queries_[kQueryCount] = {};
+    bool pending_[kQueryCount] = {}; // Query issued and its result not read yet
+    int next_ = 0;                   // Slot the next begin() uses
+    int oldest_ = 0;                 // Oldest slot that may still be pending
+    bool active_ = false;            // begin() called and end() not yet
+    bool hasResult_ = false;         // A first (discarded) result was read
+    bool supported_ = false;
+};
+
+#endif // GPU_TIMER_H
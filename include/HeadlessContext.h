@@ -0,0 +1,44 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+// OpenGL 3.3 core context with no window or display, for benchmarks and CI runs.
+// Uses a surfaceless EGL display (Mesa's llvmpipe works without any GPU), so there is
+// no default framebuffer: everything is rendered into an FBO owned by this class.
+// Only available when built with 'make HEADLESS=1'; otherwise the constructor throws.
+class HeadlessContext
+{
+public:
+    // Creates the context, makes it current and binds a width x height FBO.
+    // Throws std::runtime_error on failure.
+    HeadlessContext(int width, int height);
+    ~HeadlessContext();
+
+    // Prevent copying/assignment
+    HeadlessContext(const HeadlessContext &) = delete;
+    HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+    // Binds the offscreen framebuffer as the draw and read target
+    void bindFramebuffer() const;
+
+    // Stands in for a buffer swap: waits for the frame to finish on the GPU so frame
+    // times measure real rendering work rather than how fast commands can be queued
+    void finishFrame() const;
+
+private:
+    int width_;
+    int height_;
+    void *display_ = nullptr; // EGLDisplay
+    void *context_ = nullptr; // EGLContext
+    unsigned int fbo_ = 0;
+    unsigned int colorBuffer_ = 0;
+    unsigned int depthBuffer_ = 0;
+
+    void createContext();
+    void createFramebuffer();
+    void destroy();
+};
+
+#endif // HEADLESS_CONTEXT_H
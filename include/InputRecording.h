@@ -0,0 +1,68 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct InputState
+{
+    bool forward = false;
+    bool backward = false;
+    bool left = false;
+    bool right = false;
+    bool up = false;
+    bool down = false;
+    bool toggleFly = false; // true only on the frame the fly key goes down
+
+    float mouseDX = 0.0f; // mouse delta x
+    float mouseDY = 0.0f; // mouse delta y
+};
+
+// One recorded frame: the input sampled that frame and how many fixed update ticks it ran.
+// Replaying the tick counts (instead of the wall-clock accumulator) is what makes a replay
+// simulate exactly the same steps as the recording, however fast the machine is.
+struct InputFrame
+{
+    InputState input;
+    uint32_t ticks = 0;
+};
+
+// Streams InputFrames to a compact binary file (16 byte header, 11 bytes per frame, little endian).
+class InputRecorder
+{
+public:
+    // Throws std::runtime_error if the file cannot be created
+    InputRecorder(const std::string &path, double fixedTimestep);
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder &) = delete;
+    InputRecorder &operator=(const InputRecorder &) = delete;
+
+    void recordFrame(const InputFrame &frame);
+    size_t frameCount() const { return frameCount_; }
+
+private:
+    std::ofstream file_;
+    size_t frameCount_ = 0;
+};
+
+// Loads a file written by InputRecorder and hands the frames back in order.
+class InputPlayback
+{
+public:
+    // Throws std::runtime_error if the file is missing, malformed, or was recorded with another timestep
+    InputPlayback(const std::string &path, double fixedTimestep);
+
+    // Copies the next frame into 'frame'; returns false once every frame was played
+    bool nextFrame(InputFrame &frame);
+    bool finished() const { return next_ >= frames_.size(); }
+    size_t frameCount() const { return frames_.size(); }
+
+private:
+    std::vector<InputFrame> frames_;
+    size_t next_ = 0;
+};
+
+#endif // INPUT_RECORDING_H
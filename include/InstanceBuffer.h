@@ -0,0 +1,40 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Mesh;
+
+// Per-instance data read by the instanced vertex shader (attribute locations 4-8)
+struct InstanceData
+{
+    glm::mat4 model;    // Object to world transform (locations 4-7, one vec4 column each)
+    float layer = -1.0f; // Texture array layer for every face, or -1 to keep the mesh's own layers (location 8)
+};
+
+// GPU buffer holding InstanceData for drawing many copies of a Mesh in one call
+class InstanceBuffer
+{
+public:
+    unsigned int VBO;
+    size_t count = 0;    // Number of instances uploaded
+    size_t capacity = 0; // Number of instances the buffer storage can hold
+
+    InstanceBuffer();
+    ~InstanceBuffer();
+
+    // Prevent copying/assignment (owns a GL buffer)
+    InstanceBuffer(const InstanceBuffer &) = delete;
+    InstanceBuffer &operator=(const InstanceBuffer &) = delete;
+
+    // Adds the per-instance attributes to the mesh's VAO, sourced from this buffer
+    void attachTo(const Mesh &mesh) const;
+
+    // Replaces the buffer contents. The old storage is orphaned first so the driver
+    // does not have to wait for draws still reading last frame's instances.
+    void upload(const std::vector<InstanceData> &instances);
+};
+
+#endif // INSTANCE_BUFFER_H
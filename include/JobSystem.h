@@ -0,0 +1,140 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+// Tracks a group of jobs: run() increments it, each job decrements it when it finishes
+// (also when it throws). JobSystem::wait() on a counter is how one piece of work depends
+// on another.
+struct JobCounter
+{
+    std::atomic<int> pending{0};
+
+    // First exception thrown by one of the jobs, rethrown by JobSystem::wait()
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Engine-wide work-stealing scheduler, so meshing, rasterization and later subsystems share
+// one set of threads instead of each oversubscribing the cores with its own pool.
+//
+// Every thread owns a deque: it pushes and pops its own jobs at the back (newest first, still
+// warm in cache) and, when it runs dry, steals the oldest job from the front of another
+// thread's deque. The thread that created the JobSystem (the main thread) is thread 0 and
+// only runs jobs while it waits on a counter, so waiting never idles a core.
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+
+    // threadCount 0 uses every hardware thread (the creating thread is one of them).
+    // Workers are pinned to one CPU each where the OS allows it.
+    explicit JobSystem(unsigned int threadCount = 0);
+    ~JobSystem();
+
+    // Prevent copying/assignment (owns worker threads)
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(queues_.size()); }
+
+    // Index (0 to getThreadCount() - 1) of the calling thread, for per-thread scratch data.
+    // Threads the JobSystem does not know share index 0 with the main thread.
+    unsigned int getCurrentThreadIndex() const;
+
+    // Queues a job on the calling thread's deque. Any thread may call this, including jobs.
+    void run(Job job, JobCounter *counter = nullptr);
+
+    // Runs queued jobs on the calling thread until the counter reaches zero, then rethrows
+    // the first exception one of its jobs threw. Safe inside a job: the waiting worker keeps
+    // executing other jobs meanwhile.
+    void wait(const JobCounter &counter);
+
+    // Calls body(begin, end) over [0, count) in ranges of at most 'grain' items, spread over
+    // all threads, and returns once every range is done
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, const Body &body)
+    {
+        if (count == 0)
+            return;
+        grain = std::max<size_t>(1, grain);
+        if (count <= grain || queues_.size() == 1)
+        {
+            body(size_t(0), count);
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t begin = 0; begin < count; begin += grain)
+        {
+            size_t end = std::min(count, begin + grain);
+            run([&body, begin, end]()
+                { body(begin, end); },
+                &counter);
+        }
+        wait(counter);
+    }
+
+    // Per-thread counters since the last resetStats(); index 0 is the main thread
+    struct ThreadStats
+    {
+        uint64_t jobsRun = 0;
+        uint64_t jobsStolen = 0; // Jobs this thread took from another thread's deque
+        double busyMs = 0.0;     // Time spent inside jobs
+    };
+    std::vector<ThreadStats> getThreadStats() const;
+    double getStatsWindowMs() const; // Wall time since resetStats()
+    void resetStats();
+    // Prints the utilization (busy time / wall time) and job counts of every thread
+    void reportStats(std::ostream &out) const;
+
+private:
+    struct QueuedJob
+    {
+        Job job;
+        JobCounter *counter = nullptr;
+    };
+
+    struct ThreadQueue
+    {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs; // Owner uses the back, thieves the front
+
+        // Written by whichever thread runs the job, read by reportStats()
+        std::atomic<uint64_t> jobsRun{0};
+        std::atomic<uint64_t> jobsStolen{0};
+        std::atomic<uint64_t> busyNs{0};
+    };
+
+    std::vector<std::unique_ptr<ThreadQueue>> queues_; // [0] = main thread
+    std::vector<std::thread> workers_;
+    std::atomic<int> queuedJobs_{0}; // Jobs sitting in any deque
+
+    // Idle workers sleep here until a job is queued
+    std::mutex sleepMutex_;
+    std::condition_variable wakeWorkers_;
+    bool stopping_ = false;
+
+    std::chrono::steady_clock::time_point statsStart_;
+
+    bool takeJob(unsigned int self, QueuedJob &job, bool &stolen);
+    bool runOneJob(unsigned int self); // False if every deque was empty
+    void workerLoop(unsigned int index);
+};
+
+#endif // JOB_SYSTEM_H
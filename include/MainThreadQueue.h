@@ -0,0 +1,89 @@
+#ifndef MAIN_THREAD_QUEUE_H
+#define MAIN_THREAD_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+enum class TaskPriority : uint8_t
+{
+    HIGH = 0, // Needed for the next frame to look right (e.g. a block the player just edited)
+    NORMAL,
+    LOW,      // Streaming and other work that can trail behind
+    COUNT
+};
+
+// Hands work that must run on the main thread (anything touching the GL context) from
+// worker threads back to it.
+//
+// submit() may be called from any thread and never blocks: tasks are pushed onto an
+// intrusive lock-free multi-producer single-consumer list (one atomic exchange per push).
+// The main thread moves them into per-priority lists when it drains, where tasks sharing a
+// coalescing key collapse into the latest submission, so re-uploading a chunk that was
+// edited three times before the main thread got to it only uploads the last mesh.
+class MainThreadQueue
+{
+public:
+    using Task = std::function<void()>;
+    static const uint64_t kNoCoalescing = 0;
+
+    MainThreadQueue();
+    ~MainThreadQueue();
+
+    // Prevent copying/assignment (owns the queued nodes)
+    MainThreadQueue(const MainThreadQueue &) = delete;
+    MainThreadQueue &operator=(const MainThreadQueue &) = delete;
+
+    // Any thread. A task with a non-zero coalescingKey replaces any pending task with the same key.
+    void submit(Task task, TaskPriority priority = TaskPriority::NORMAL, uint64_t coalescingKey = kNoCoalescing);
+
+    // Main thread only. Runs pending tasks, highest priority first and in submission order
+    // within a priority, until budgetMs has passed (at least one task always runs).
+    // Returns the number of tasks run; the rest wait for the next call.
+    size_t drain(double budgetMs);
+    size_t drainAll();
+
+    // Main thread only. Drops every pending task without running it.
+    void clear();
+
+    // Main thread only. Tasks already moved off the lock-free list (call after drain)
+    size_t pendingCount() const;
+
+    struct Stats
+    {
+        size_t executed = 0;  // Tasks run
+        size_t coalesced = 0; // Tasks dropped because a newer one with the same key arrived
+        size_t deferred = 0;  // Drains that ran out of budget with work left
+    };
+    const Stats &getStats() const { return stats_; }
+    void resetStats() { stats_ = Stats(); }
+
+private:
+    struct Node
+    {
+        std::atomic<Node *> next{nullptr};
+        Task task;         // Empty once superseded by a newer task with the same key
+        uint64_t key = kNoCoalescing;
+        TaskPriority priority = TaskPriority::NORMAL;
+    };
+
+    // Producers swap themselves in at head_; the consumer follows next pointers from tail_.
+    // stub_ keeps the list non-empty so push never has to check for an empty list.
+    std::atomic<Node *> head_;
+    Node *tail_;
+    Node stub_;
+
+    // Consumer side
+    std::deque<Node *> pending_[static_cast<int>(TaskPriority::COUNT)];
+    std::unordered_map<uint64_t, Node *> latestByKey_;
+    Stats stats_;
+
+    void push(Node *node);
+    Node *pop();            // Null if the list is empty (or a producer is half-way through a push)
+    void collectSubmitted(); // Moves everything pushed so far into pending_, coalescing by key
+};
+
+#endif // MAIN_THREAD_QUEUE_H
@@ -4,6 +4,9 @@
 #include <cstddef>
 #include <vector>
 #include <utility>
+#include <tuple>
+
+class QuadIndexBuffer;
 
 // Represents geometric data (vertices, indices) and its OpenGL buffers (VAO, VBO, EBO)
 class Mesh
@@ -11,10 +14,20 @@ class Mesh
 public:
     unsigned int VAO, VBO, EBO;
     unsigned int indexCount; // Number of indices to draw
+    unsigned int indexType;  // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, pass to glDrawElements
+    bool ownsIndexBuffer;    // False when EBO is a shared QuadIndexBuffer
 
-    // Constructor takes vertex and index data and sets up OpenGL buffers
+    // Constructor takes vertex and index data and sets up OpenGL buffers.
+    // Indices are stored as 16 bit when every vertex can be addressed with them.
     Mesh(const float *vertices, size_t vertexSize, const unsigned int *indices, size_t indexSize, size_t vertexStride, const std::vector<std::tuple<unsigned int, size_t, int>> &attributeLayout);
 
+    // Mesh made of quads (4 vertices each) that draws with the shared quad index buffer
+    // instead of storing indices. Throws if quadCount exceeds QuadIndexBuffer::kMaxQuads.
+    // 'integerAttributeLayout' lists 32-bit unsigned attributes the shader reads as 'uint'
+    // (such as PackedVertex's packed normal); 'attributeLayout' lists the float ones.
+    Mesh(const float *vertices, size_t vertexSize, const QuadIndexBuffer &quadIndices, size_t quadCount, size_t vertexStride, const std::vector<std::tuple<unsigned int, size_t, int>> &attributeLayout,
+         const std::vector<std::tuple<unsigned int, size_t, int>> &integerAttributeLayout = {});
+
     // Destructor to clean up OpenGL buffers
     ~Mesh();
 
@@ -23,6 +36,10 @@ public:
 
     // Unbind the mesh's VAO
     void unbind() const;
+
+private:
+    void setupVertexArray(const float *vertices, size_t vertexSize, size_t vertexStride, const std::vector<std::tuple<unsigned int, size_t, int>> &attributeLayout,
+                          const std::vector<std::tuple<unsigned int, size_t, int>> &integerAttributeLayout = {});
 };
 
 #endif
\ No newline at end of file
@@ -8,15 +8,24 @@
 namespace MeshBuilder
 {
 
+    // Geometry one cube adds to a mesh
+    const size_t CUBE_QUAD_COUNT = 6;
+    const size_t CUBE_VERTEX_COUNT = 24;
+    const size_t CUBE_INDEX_COUNT = 36;
+
     // Helper function: Appends the vertices and indices for a single cube
     // centered at 'centerOffset' to the provided MeshData.
     // Assumes standard cube size of 1.0f.
-    void appendCube(MeshData &meshData, const glm::vec3 &centerOffset, std::map<BlockType, FaceToLayer> &layer_mapping, BlockType blockType, float size = 1.0f)
+    // 'meshData' is anything with the writer interface (vertexCount, addVertex, addQuad):
+    // MeshData, ArenaMeshData or a PackedMeshWriter. Writes straight into it (no temporaries),
+    // so with enough capacity reserved it does not allocate.
+    template <typename MeshType>
+    void appendCube(MeshType &meshData, const glm::vec3 &centerOffset, const std::map<BlockType, FaceToLayer> &layer_mapping, BlockType blockType, float size = 1.0f)
     {
         float halfSize = size / 2.0f;
 
         // Calculate the base index for vertices BEFORE adding this cube's vertices
-        unsigned int baseVertexIndex = static_cast<unsigned int>(meshData.vertices.size());
+        unsigned int baseVertexIndex = static_cast<unsigned int>(meshData.vertexCount());
 
         // Define the 8 corners RELATIVE to the centerOffset
         glm::vec3 p_rrr = centerOffset + glm::vec3(halfSize, halfSize, halfSize);    // +X, +Y, +Z
@@ -28,162 +37,58 @@ namespace MeshBuilder
         glm::vec3 p_llr = centerOffset + glm::vec3(-halfSize, -halfSize, halfSize);  // -X, -Y, +Z
         glm::vec3 p_lll = centerOffset + glm::vec3(-halfSize, -halfSize, -halfSize); // -X, -Y, -Z
 
-        // Normals (remain the same regardless of offset)
-        glm::vec3 n_front = {0.0f, 0.0f, 1.0f};   // +Z
-        glm::vec3 n_back = {0.0f, 0.0f, -1.0f};   // -Z
-        glm::vec3 n_right = {1.0f, 0.0f, 0.0f};   // +X
-        glm::vec3 n_left = {-1.0f, 0.0f, 0.0f};   // -X
-        glm::vec3 n_top = {0.0f, 1.0f, 0.0f};     // +Y
-        glm::vec3 n_bottom = {0.0f, -1.0f, 0.0f}; // -Y
+        // Texture layer (looked up without inserting, chunks are meshed on several threads at once)
+        auto mapping = layer_mapping.find(blockType);
+        FaceToLayer block_layer_map = mapping != layer_mapping.end() ? mapping->second : FaceToLayer{};
 
-        // UV Coordinates (standard for each face)
-        glm::vec2 uv_bl = {0.0f, 0.0f};
-        glm::vec2 uv_br = {1.0f, 0.0f};
-        glm::vec2 uv_tr = {1.0f, 1.0f};
-        glm::vec2 uv_tl = {0.0f, 1.0f};
-
-        // Texture layer
-        FaceToLayer block_layer_map = layer_mapping[blockType];
-
-        // Temporary storage for this cube's data
-        std::vector<glm::vec3> cubeVertices;
-        std::vector<glm::vec3> cubeNormals;
-        std::vector<glm::vec2> cubeTexCoords;
-        std::vector<float> cubeLayerIndices;
-        std::vector<unsigned int> cubeIndices;
-
-        // Reserve space for efficiency (24 vertices, 36 indices)
-        cubeVertices.reserve(24);
-        cubeNormals.reserve(24);
-        cubeTexCoords.reserve(24);
-        cubeLayerIndices.reserve(24);
-        cubeIndices.reserve(36);
-
-        // Add vertices, normals, UVs, texture layer for each face (CCW from outside)
-        // Front (+Z)
-        cubeVertices.push_back(p_llr);
-        cubeVertices.push_back(p_rlr);
-        cubeVertices.push_back(p_rrr);
-        cubeVertices.push_back(p_lrr);
-        for (int i = 0; i < 4; ++i)
-            cubeNormals.push_back(n_front);
-        cubeTexCoords.push_back(uv_bl);
-        cubeTexCoords.push_back(uv_br);
-        cubeTexCoords.push_back(uv_tr);
-        cubeTexCoords.push_back(uv_tl);
-        for (int i = 0; i < 4; ++i)
-        { // Add index 4 times
-            cubeLayerIndices.push_back(static_cast<float>(block_layer_map.front));
-        }
-        // Back (-Z)
-        cubeVertices.push_back(p_rll);
-        cubeVertices.push_back(p_lll);
-        cubeVertices.push_back(p_lrl);
-        cubeVertices.push_back(p_rrl);
-        for (int i = 0; i < 4; ++i)
-            cubeNormals.push_back(n_back);
-        cubeTexCoords.push_back(uv_bl);
-        cubeTexCoords.push_back(uv_br);
-        cubeTexCoords.push_back(uv_tr);
-        cubeTexCoords.push_back(uv_tl);
-        for (int i = 0; i < 4; ++i)
-        { // Add index 4 times
-            cubeLayerIndices.push_back(static_cast<float>(block_layer_map.back));
-        }
-        // Right (+X)
-        cubeVertices.push_back(p_rlr);
-        cubeVertices.push_back(p_rll);
-        cubeVertices.push_back(p_rrl);
-        cubeVertices.push_back(p_rrr);
-        for (int i = 0; i < 4; ++i)
-            cubeNormals.push_back(n_right);
-        cubeTexCoords.push_back(uv_bl);
-        cubeTexCoords.push_back(uv_br);
-        cubeTexCoords.push_back(uv_tr);
-        cubeTexCoords.push_back(uv_tl);
-        for (int i = 0; i < 4; ++i)
-        { // Add index 4 times
-            cubeLayerIndices.push_back(static_cast<float>(block_layer_map.right));
-        }
-        // Left (-X)
-        cubeVertices.push_back(p_lll);
-        cubeVertices.push_back(p_llr);
-        cubeVertices.push_back(p_lrr);
-        cubeVertices.push_back(p_lrl);
-        for (int i = 0; i < 4; ++i)
-            cubeNormals.push_back(n_left);
-        cubeTexCoords.push_back(uv_bl);
-        cubeTexCoords.push_back(uv_br);
-        cubeTexCoords.push_back(uv_tr);
-        cubeTexCoords.push_back(uv_tl);
-        for (int i = 0; i < 4; ++i)
-        { // Add index 4 times
-            cubeLayerIndices.push_back(static_cast<float>(block_layer_map.left));
-        }
-        // Top (+Y)
-        cubeVertices.push_back(p_lrr);
-        cubeVertices.push_back(p_rrr);
-        cubeVertices.push_back(p_rrl);
-        cubeVertices.push_back(p_lrl);
-        for (int i = 0; i < 4; ++i)
-            cubeNormals.push_back(n_top);
-        cubeTexCoords.push_back(uv_bl);
-        cubeTexCoords.push_back(uv_br);
-        cubeTexCoords.push_back(uv_tr);
-        cubeTexCoords.push_back(uv_tl);
-        for (int i = 0; i < 4; ++i)
-        { // Add index 4 times
-            cubeLayerIndices.push_back(static_cast<float>(block_layer_map.top));
-        }
-        // Bottom (-Y)
-        cubeVertices.push_back(p_lll);
-        cubeVertices.push_back(p_rll);
-        cubeVertices.push_back(p_rlr);
-        cubeVertices.push_back(p_llr);
-        for (int i = 0; i < 4; ++i)
-            cubeNormals.push_back(n_bottom);
-        cubeTexCoords.push_back(uv_bl);
-        cubeTexCoords.push_back(uv_br);
-        cubeTexCoords.push_back(uv_tr);
-        cubeTexCoords.push_back(uv_tl);
-        for (int i = 0; i < 4; ++i)
-        { // Add index 4 times
-            cubeLayerIndices.push_back(static_cast<float>(block_layer_map.bottom));
-        }
-        // Add indices relative to the start of *this cube's* vertices (0-23)
-        for (unsigned int i = 0; i < 6; ++i)
-        { // For each face (which added 4 vertices)
-            unsigned int faceBase = i * 4;
-            cubeIndices.push_back(faceBase + 0);
-            cubeIndices.push_back(faceBase + 1);
-            cubeIndices.push_back(faceBase + 2);
-            cubeIndices.push_back(faceBase + 0);
-            cubeIndices.push_back(faceBase + 2);
-            cubeIndices.push_back(faceBase + 3);
-        }
-
-        // --- Append this cube's data to the main MeshData ---
+        // Per face: 4 corners (CCW from outside), normal and texture layer
+        struct Face
+        {
+            glm::vec3 corners[4];
+            glm::vec3 normal;
+            int layer;
+        };
+        const Face faces[6] = {
+            {{p_llr, p_rlr, p_rrr, p_lrr}, {0.0f, 0.0f, 1.0f}, block_layer_map.front},   // Front (+Z)
+            {{p_rll, p_lll, p_lrl, p_rrl}, {0.0f, 0.0f, -1.0f}, block_layer_map.back},   // Back (-Z)
+            {{p_rlr, p_rll, p_rrl, p_rrr}, {1.0f, 0.0f, 0.0f}, block_layer_map.right},   // Right (+X)
+            {{p_lll, p_llr, p_lrr, p_lrl}, {-1.0f, 0.0f, 0.0f}, block_layer_map.left},   // Left (-X)
+            {{p_lrr, p_rrr, p_rrl, p_lrl}, {0.0f, 1.0f, 0.0f}, block_layer_map.top},     // Top (+Y)
+            {{p_lll, p_rll, p_rlr, p_llr}, {0.0f, -1.0f, 0.0f}, block_layer_map.bottom}, // Bottom (-Y)
+        };
 
-        // Append vertices, normals, texCoords, layer indices
-        meshData.vertices.insert(meshData.vertices.end(), cubeVertices.begin(), cubeVertices.end());
-        meshData.normals.insert(meshData.normals.end(), cubeNormals.begin(), cubeNormals.end());
-        meshData.texCoords.insert(meshData.texCoords.end(), cubeTexCoords.begin(), cubeTexCoords.end());
-        meshData.layerIndices.insert(meshData.layerIndices.end(), cubeLayerIndices.begin(), cubeLayerIndices.end());
+        // UV Coordinates (standard for each face)
+        // Scaled with the cube so larger cubes repeat the texture once per block instead of stretching it
+        const glm::vec2 uvs[4] = {{0.0f, 0.0f}, {size, 0.0f}, {size, size}, {0.0f, size}};
 
-        // Append indices, making sure to offset them by baseVertexIndex
-        for (unsigned int index : cubeIndices)
+        for (unsigned int f = 0; f < 6; ++f)
         {
-            meshData.indices.push_back(baseVertexIndex + index);
+            const Face &face = faces[f];
+            for (int corner = 0; corner < 4; ++corner)
+                meshData.addVertex(face.corners[corner], face.normal, uvs[corner], static_cast<float>(face.layer));
+
+            // Two triangles per face, offset by this cube's first vertex (writers that draw with
+            // the shared quad index buffer ignore this)
+            meshData.addQuad(baseVertexIndex + f * 4);
         }
     }
 
     // ---- The Main Function to Generate the World Mesh ----
     // Fulfills the role of the original `generateMesh(const World& world, MeshData& meshData)` signature.
-    void generateWorldMesh(const World &world, MeshData &meshData, std::map<BlockType, FaceToLayer> &layer_mapping)
+    template <typename MeshType>
+    void generateWorldMesh(const World &world, MeshType &meshData, const std::map<BlockType, FaceToLayer> &layer_mapping)
     {
         // Start with an empty mesh for the entire world
         meshData.clear();
 
+        // Reserve for every solid block up front instead of growing with each cube
+        size_t solidCount = 0;
+        for (int y = 0; y < WORLD_HEIGHT; ++y)
+            for (int z = 0; z < WORLD_DEPTH; ++z)
+                for (int x = 0; x < WORLD_WIDTH; ++x)
+                    solidCount += world.isSolid(x, y, z) ? 1 : 0;
+        meshData.reserve(solidCount * CUBE_VERTEX_COUNT, solidCount * CUBE_INDEX_COUNT);
+
         // Iterate through every voxel position in the world
         for (int y = 0; y < WORLD_HEIGHT; ++y)
         {
@@ -213,4 +118,142 @@ namespace MeshBuilder
         // At this point, meshData contains the combined geometry
         // of all solid blocks, with no optimizations (hidden faces included).
     }
-};
\ No newline at end of file
+
+    // ---- Level of detail ----
+    // Number of LOD levels: 0 = full resolution, then 2x, 4x and 8x downsampled
+    const int LOD_LEVELS = 4;
+    static_assert((1 << (LOD_LEVELS - 1)) <= CHUNK_SIZE, "The coarsest LOD cell must fit in a chunk");
+
+    // Picks the block type a downsampled cell of (cellSize^3) voxels is drawn as: the most
+    // common solid type inside it. A cell is only air when it is completely empty, which
+    // errs on the side of keeping distant silhouettes closed rather than punching holes.
+    inline BlockType dominantBlockType(const World &world, const glm::ivec3 &cellMin, int cellSize)
+    {
+        if (cellSize == 1)
+            return world.getBlockType(cellMin.x, cellMin.y, cellMin.z);
+
+        int counts[256] = {};
+        for (int y = 0; y < cellSize; ++y)
+            for (int z = 0; z < cellSize; ++z)
+                for (int x = 0; x < cellSize; ++x)
+                    counts[static_cast<uint8_t>(world.getBlockType(cellMin.x + x, cellMin.y + y, cellMin.z + z))]++;
+
+        int best = 0; // AIR unless any solid block is found
+        int bestCount = 0;
+        for (int type = 1; type < 256; ++type)
+        {
+            if (counts[type] > bestCount)
+            {
+                best = type;
+                bestCount = counts[type];
+            }
+        }
+        return static_cast<BlockType>(best);
+    }
+
+    // Cells of one chunk at one LOD, each classified as the block type it is drawn as
+    struct ChunkCells
+    {
+        BlockType types[CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE]; // y-major, then z, then x
+        glm::ivec3 origin;
+        int cellSize = 1;
+        int cellsPerAxis = CHUNK_SIZE;
+        size_t solidCount = 0; // Cells that become a cube
+
+        size_t vertexCount() const { return solidCount * CUBE_VERTEX_COUNT; }
+        size_t indexCount() const { return solidCount * CUBE_INDEX_COUNT; }
+        size_t quadCount() const { return solidCount * CUBE_QUAD_COUNT; }
+    };
+
+    // First half of meshing a chunk at the given LOD: every (1 << lod)^3 block cell becomes a
+    // single cube of the cell's dominant type, so each level cuts the cube count by 8x.
+    // The counts tell the caller how much memory the mesh needs before any of it is written.
+    inline void classifyChunk(const World &world, int cx, int cy, int cz, int lod, ChunkCells &cells)
+    {
+        cells.cellSize = 1 << lod;
+        cells.cellsPerAxis = CHUNK_SIZE / cells.cellSize;
+        cells.origin = glm::ivec3(cx * CHUNK_SIZE, cy * CHUNK_SIZE, cz * CHUNK_SIZE);
+        cells.solidCount = 0;
+
+        for (int y = 0, cell = 0; y < cells.cellsPerAxis; ++y)
+        {
+            for (int z = 0; z < cells.cellsPerAxis; ++z)
+            {
+                for (int x = 0; x < cells.cellsPerAxis; ++x, ++cell)
+                {
+                    glm::ivec3 cellMin = cells.origin + glm::ivec3(x, y, z) * cells.cellSize;
+                    cells.types[cell] = dominantBlockType(world, cellMin, cells.cellSize);
+                    cells.solidCount += cells.types[cell] != BlockType::AIR ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    // Second half: appends one cube per solid cell to any mesh writer (see appendCube).
+    // Cells never cross the chunk border and every cube is closed, so chunks at different
+    // LODs next to each other leave no cracks at the seam.
+    template <typename MeshType>
+    void emitChunkCells(const ChunkCells &cells, MeshType &meshData, const std::map<BlockType, FaceToLayer> &layer_mapping)
+    {
+        for (int y = 0, cell = 0; y < cells.cellsPerAxis; ++y)
+        {
+            for (int z = 0; z < cells.cellsPerAxis; ++z)
+            {
+                for (int x = 0; x < cells.cellsPerAxis; ++x, ++cell)
+                {
+                    BlockType type = cells.types[cell];
+                    if (type == BlockType::AIR)
+                        continue;
+
+                    glm::ivec3 cellMin = cells.origin + glm::ivec3(x, y, z) * cells.cellSize;
+                    glm::vec3 cellCenter = glm::vec3(cellMin) + glm::vec3(0.5f * static_cast<float>(cells.cellSize));
+                    appendCube(meshData, cellCenter, layer_mapping, type, static_cast<float>(cells.cellSize));
+                }
+            }
+        }
+    }
+
+    // PackedQuad positions have 10 bits per axis
+    static_assert(WORLD_WIDTH <= 1024 && WORLD_HEIGHT <= 1024 && WORLD_DEPTH <= 1024, "World too large for PackedQuad positions");
+
+    // Second half for the vertex-pulling path: writes one PackedQuad per cube face into 'quads',
+    // which must hold cells.quadCount() records. Faces come out in appendCube's order.
+    inline void emitChunkQuads(const ChunkCells &cells, PackedQuad *quads, const std::map<BlockType, FaceToLayer> &layer_mapping)
+    {
+        unsigned int sizeLog2 = 0;
+        while ((1 << sizeLog2) < cells.cellSize)
+            ++sizeLog2;
+
+        for (int y = 0, cell = 0; y < cells.cellsPerAxis; ++y)
+        {
+            for (int z = 0; z < cells.cellsPerAxis; ++z)
+            {
+                for (int x = 0; x < cells.cellsPerAxis; ++x, ++cell)
+                {
+                    BlockType type = cells.types[cell];
+                    if (type == BlockType::AIR)
+                        continue;
+
+                    auto mapping = layer_mapping.find(type);
+                    FaceToLayer layers = mapping != layer_mapping.end() ? mapping->second : FaceToLayer{};
+                    const int faceLayers[6] = {layers.front, layers.back, layers.right, layers.left, layers.top, layers.bottom};
+
+                    glm::ivec3 cellMin = cells.origin + glm::ivec3(x, y, z) * cells.cellSize;
+                    for (unsigned int face = 0; face < 6; ++face)
+                        *quads++ = PackedQuad::make(cellMin, face, sizeLog2, static_cast<unsigned int>(faceLayers[face]));
+                }
+            }
+        }
+    }
+
+    // Generates the mesh for one chunk at the given LOD into a MeshData (both halves above)
+    template <typename MeshType>
+    void generateChunkMesh(const World &world, int cx, int cy, int cz, int lod, MeshType &meshData, const std::map<BlockType, FaceToLayer> &layer_mapping)
+    {
+        meshData.clear();
+        ChunkCells cells;
+        classifyChunk(world, cx, cy, cz, lod, cells);
+        meshData.reserve(cells.vertexCount(), cells.indexCount());
+        emitChunkCells(cells, meshData, layer_mapping);
+    }
+};
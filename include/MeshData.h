@@ -1,26 +1,100 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include <cstddef>
+#include <cmath>
+#include <cstdint>
 #include <utility>
+#include <tuple>
 // Use GLM for vector types, common in OpenGL projects
 // You might need to install/include GLM: https://glm.g-truc.net/
 #include <glm/glm.hpp>
+#include "Arena.h"
 
-struct MeshData
+// One vertex of a GL chunk mesh, written by PackedMeshWriter. The normal is packed into one
+// integer (see packNormal) and decoded by the PACKED_NORMAL variant of shader.vs, so a vertex
+// is 28 bytes instead of MeshData's 36.
+struct PackedVertex
 {
-    std::vector<glm::vec3> vertices;   // Vertex positions (x, y, z)
-    std::vector<glm::vec3> normals;    // Surface normals (for lighting)
-    std::vector<glm::vec2> texCoords;  // Texture coordinates (u, v)
-    std::vector<float> layerIndices;   // Which texture to grab from texture array
-    std::vector<unsigned int> indices; // Indices defining triangles
+    glm::vec3 position;
+    uint32_t normal; // x, y, z as signed 8-bit fractions of 127 in bytes 0, 1, 2
+    glm::vec2 texCoord;
+    float layer;
 
-    std::vector<std::tuple<unsigned int, size_t, int>> attributeLayout = {
+    static uint32_t packNormal(const glm::vec3 &normal)
+    {
+        auto snorm8 = [](float value)
+        {
+            return static_cast<uint32_t>(static_cast<uint8_t>(static_cast<int8_t>(std::lround(glm::clamp(value, -1.0f, 1.0f) * 127.0f))));
+        };
+        return snorm8(normal.x) | snorm8(normal.y) << 8 | snorm8(normal.z) << 16;
+    }
+
+    // Float attributes (glVertexAttribPointer): location, offset, component count
+    static inline const std::vector<std::tuple<unsigned int, size_t, int>> attributeLayout = {
+        {0, 0, 3},                  // Position
+        {2, 4 * sizeof(float), 2},  // TexCoord
+        {3, 6 * sizeof(float), 1}   // Layer index
+    };
+    // Integer attributes (glVertexAttribIPointer, 'uint' in the shader)
+    static inline const std::vector<std::tuple<unsigned int, size_t, int>> integerAttributeLayout = {
+        {1, 3 * sizeof(float), 1} // Packed normal
+    };
+};
+static_assert(sizeof(PackedVertex) == 7 * sizeof(float), "PackedVertex must match the GL attribute layout");
+
+// One block face for the vertex-pulling path (QuadMesh): 8 bytes instead of 4 PackedVertex
+// (112 bytes). The vertex shader (assets/shaders/quads.vs) rebuilds the corners from it.
+//   position: cell minimum corner in world blocks, 10 bits per axis (x | y << 10 | z << 20)
+//   faceSizeLayer: face (bits 0-2, appendCube's order) | log2 of the cube size (bits 3-5)
+//                  | texture layer (bits 8-31)
+struct PackedQuad
+{
+    uint32_t position;
+    uint32_t faceSizeLayer;
+
+    static PackedQuad make(const glm::ivec3 &cellMin, unsigned int face, unsigned int sizeLog2, unsigned int layer)
+    {
+        return PackedQuad{static_cast<uint32_t>(cellMin.x) | static_cast<uint32_t>(cellMin.y) << 10 | static_cast<uint32_t>(cellMin.z) << 20,
+                          face | sizeLog2 << 3 | layer << 8};
+    }
+};
+static_assert(sizeof(PackedQuad) == 8, "PackedQuad must match the GL_RG32UI texel quads.vs reads");
+
+// Mesh geometry as separate attribute arrays. 'Allocator' picks where the arrays live:
+// MeshData uses the heap, ArenaMeshData an Arena (for per-job temporaries while meshing).
+template <template <typename> class Allocator>
+struct BasicMeshData
+{
+    template <typename T>
+    using Array = std::vector<T, Allocator<T>>;
+
+    Array<glm::vec3> vertices;   // Vertex positions (x, y, z)
+    Array<glm::vec3> normals;    // Surface normals (for lighting)
+    Array<glm::vec2> texCoords;  // Texture coordinates (u, v)
+    Array<float> layerIndices;   // Which texture to grab from texture array
+    Array<unsigned int> indices; // Indices defining triangles
+
+    // Shared by every mesh (all meshes use the same interleaved layout)
+    static inline const std::vector<std::tuple<unsigned int, size_t, int>> attributeLayout = {
         {0, 0, 3},                 // Pos: loc 0, offset 0, size 3
         {1, 3 * sizeof(float), 3}, // Normal: loc 1, offset 3*float, size 3
         {2, 6 * sizeof(float), 2}, // TexCoord: loc 2, offset 6*float, size 2
         {3, 8 * sizeof(float), 1}  // Layer index
     };
+
+    BasicMeshData() = default;
+    // Arena-backed variant; must not outlive the arena scope it was created in
+    explicit BasicMeshData(Arena &arena)
+        : vertices(Allocator<glm::vec3>(arena)),
+          normals(Allocator<glm::vec3>(arena)),
+          texCoords(Allocator<glm::vec2>(arena)),
+          layerIndices(Allocator<float>(arena)),
+          indices(Allocator<unsigned int>(arena))
+    {
+    }
+
     // Clears all data vectors
     void
     clear()
@@ -32,30 +106,102 @@ struct MeshData
         indices.clear();
     }
 
-    std::vector<float> getInterleavedVertices()
+    // Mesh writer interface (see MeshBuilder::appendCube)
+    size_t vertexCount() const { return vertices.size(); }
+    void addVertex(const glm::vec3 &position, const glm::vec3 &normal, const glm::vec2 &texCoord, float layer)
     {
-        std::vector<float> interleavedData;
-        for (int i = 0; i < vertices.size(); ++i)
+        vertices.push_back(position);
+        normals.push_back(normal);
+        texCoords.push_back(texCoord);
+        layerIndices.push_back(layer);
+    }
+    // Two triangles over the 4 vertices starting at firstVertex, in QuadIndexBuffer order
+    void addQuad(unsigned int firstVertex)
+    {
+        const unsigned int corners[6] = {0, 1, 2, 0, 2, 3};
+        for (unsigned int corner : corners)
+            indices.push_back(firstVertex + corner);
+    }
+
+    // Makes room for this many more vertices and indices without reallocating
+    void reserve(size_t vertexCount, size_t indexCount)
+    {
+        vertices.reserve(vertices.size() + vertexCount);
+        normals.reserve(normals.size() + vertexCount);
+        texCoords.reserve(texCoords.size() + vertexCount);
+        layerIndices.reserve(layerIndices.size() + vertexCount);
+        indices.reserve(indices.size() + indexCount);
+    }
+
+    // Copies the geometry from a mesh with any allocator (e.g. an arena temporary into a
+    // long-lived MeshData). Keeps this mesh's capacity, so steady-state copies do not allocate.
+    template <template <typename> class OtherAllocator>
+    void assign(const BasicMeshData<OtherAllocator> &other)
+    {
+        vertices.assign(other.vertices.begin(), other.vertices.end());
+        normals.assign(other.normals.begin(), other.normals.end());
+        texCoords.assign(other.texCoords.begin(), other.texCoords.end());
+        layerIndices.assign(other.layerIndices.begin(), other.layerIndices.end());
+        indices.assign(other.indices.begin(), other.indices.end());
+    }
+
+    // Writes the vertices in the interleaved layout into 'out', reusing its capacity
+    void getInterleavedVertices(std::vector<float> &out) const
+    {
+        out.resize(vertices.size() * 9);
+        float *dst = out.data();
+        for (size_t i = 0; i < vertices.size(); ++i, dst += 9)
         {
-            interleavedData.emplace_back(vertices[i].x);
-            interleavedData.emplace_back(vertices[i].y);
-            interleavedData.emplace_back(vertices[i].z);
+            dst[0] = vertices[i].x;
+            dst[1] = vertices[i].y;
+            dst[2] = vertices[i].z;
 
-            interleavedData.emplace_back(normals[i].x);
-            interleavedData.emplace_back(normals[i].y);
-            interleavedData.emplace_back(normals[i].z);
+            dst[3] = normals[i].x;
+            dst[4] = normals[i].y;
+            dst[5] = normals[i].z;
 
-            interleavedData.emplace_back(texCoords[i].x);
-            interleavedData.emplace_back(texCoords[i].y);
+            dst[6] = texCoords[i].x;
+            dst[7] = texCoords[i].y;
 
-            interleavedData.emplace_back(layerIndices[i]);
+            dst[8] = layerIndices[i];
         }
+    }
 
+    std::vector<float> getInterleavedVertices() const
+    {
+        std::vector<float> interleavedData;
+        getInterleavedVertices(interleavedData);
         return interleavedData;
     }
 
-    size_t getVertexStride()
+    static size_t getVertexStride()
     {
         return 9 * sizeof(float);
     }
-};
\ No newline at end of file
+};
+
+using MeshData = BasicMeshData<std::allocator>;
+using ArenaMeshData = BasicMeshData<ArenaAllocator>;
+
+// Writes mesh geometry straight into caller-provided memory in the final GPU layout (a staging
+// buffer or a mapped GL buffer), skipping the separate attribute arrays and the interleaving
+// copy. The caller sizes the memory up front (MeshBuilder::classifyChunk gives the counts).
+// Only vertices are written: every quad uses the same indices, which the GL mesh takes from the
+// shared QuadIndexBuffer.
+struct PackedMeshWriter
+{
+    PackedVertex *vertices = nullptr;
+    size_t writtenVertices = 0;
+
+    explicit PackedMeshWriter(PackedVertex *vertexMemory)
+        : vertices(vertexMemory)
+    {
+    }
+
+    size_t vertexCount() const { return writtenVertices; }
+    void addVertex(const glm::vec3 &position, const glm::vec3 &normal, const glm::vec2 &texCoord, float layer)
+    {
+        vertices[writtenVertices++] = PackedVertex{position, PackedVertex::packNormal(normal), texCoord, layer};
+    }
+    void addQuad(unsigned int) {}
+};
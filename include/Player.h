@@ -0,0 +1,56 @@
+#ifndef PLAYER_H
+#define PLAYER_H
+
+#include <glm/glm.hpp>
+
+class World;
+
+// Axis-aligned bounding box in world space
+struct AABB
+{
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// First-person player body that collides against the solid voxels of a World.
+// Movement is resolved axis by axis (Y, then X, then Z) with a swept AABB, so the
+// player can never tunnel through a block regardless of speed.
+class Player
+{
+public:
+    glm::vec3 position; // Center of the feet (bottom middle of the bounding box)
+    glm::vec3 velocity = glm::vec3(0.0f);
+    bool onGround = false;
+    bool flying = false; // Free-fly (noclip) mode, ignores gravity and collisions
+
+    // Body dimensions (in blocks)
+    float halfWidth = 0.3f;
+    float height = 1.8f;
+    float eyeHeight = 1.62f;
+    float stepHeight = 0.6f; // Ledges up to this height are climbed without jumping
+
+    // Movement tuning (blocks per second / blocks per second squared)
+    float walkSpeed = 4.3f;
+    float flySpeed = 5.0f;
+    float jumpSpeed = 9.0f;
+    float gravity = 32.0f;
+    float terminalVelocity = 60.0f;
+
+    explicit Player(const glm::vec3 &feetPosition);
+
+    // Advance the simulation by one fixed step.
+    // wishDir is the desired movement direction: horizontal when walking, free 3D when flying.
+    void update(const World &world, const glm::vec3 &wishDir, bool jump, float dt);
+
+    glm::vec3 getEyePosition() const;
+    AABB getBounds() const;
+
+private:
+    // Moves the player along one axis (0 = X, 1 = Y, 2 = Z) by at most 'delta',
+    // stopping at the first solid voxel. Returns the distance actually travelled.
+    float moveAxis(const World &world, int axis, float delta);
+
+    glm::vec3 spawnPoint_; // Where the player is put back after falling out of the world
+};
+
+#endif // PLAYER_H
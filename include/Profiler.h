@@ -0,0 +1,58 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <string>
+
+// Low-overhead CPU instrumentation.
+//
+// Zones are recorded into a fixed-size ring buffer owned by each thread, so recording
+// never locks or allocates; only the newest events per thread are kept. The buffers can
+// be written out at any time as Chrome trace JSON (chrome://tracing or ui.perfetto.dev).
+//
+// Zones are only compiled in when ENABLE_PROFILER is defined (make PROFILE=1).
+// Otherwise PROFILE_SCOPE and PROFILE_THREAD_NAME expand to nothing and cost nothing
+// (no thread ever creates its ring buffer).
+namespace Profiler
+{
+    // Monotonic timestamp in nanoseconds
+    uint64_t nowNanoseconds();
+
+    // Appends a finished zone to the calling thread's ring buffer.
+    // 'name' must outlive the profiler (use string literals).
+    void recordZone(const char *name, uint64_t startNs, uint64_t endNs);
+
+    // Label for the calling thread in exported traces
+    void setThreadName(const char *name);
+
+    // Writes every zone currently held in the ring buffers to 'path'. Safe to call while
+    // other threads keep recording. Returns false if the file cannot be written.
+    bool writeChromeTrace(const std::string &path);
+
+    // RAII marker: times the enclosing scope
+    class ScopedZone
+    {
+    public:
+        explicit ScopedZone(const char *name) : name_(name), start_(nowNanoseconds()) {}
+        ~ScopedZone() { recordZone(name_, start_, nowNanoseconds()); }
+
+        ScopedZone(const ScopedZone &) = delete;
+        ScopedZone &operator=(const ScopedZone &) = delete;
+
+    private:
+        const char *name_;
+        uint64_t start_;
+    };
+}
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) Profiler::ScopedZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,35 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+// On-disk cache of linked shader programs (glGetProgramBinary / glProgramBinary), so later
+// launches skip compiling and linking. Entries are keyed by a hash of the shader sources and
+// the driver's vendor, renderer and version strings: a driver update or an edited shader
+// simply misses. A binary the driver still rejects is ignored and the caller compiles as usual.
+// Main thread only (needs the GL context).
+namespace ProgramCache
+{
+    // Directory the binaries live in (created when needed); empty turns the cache off
+    void setDirectory(const std::string &directory);
+
+    // Key for a program built from these sources on the current driver
+    uint64_t makeKey(const std::string &vertexSource, const std::string &fragmentSource);
+
+    // Returns a linked program loaded from the cache, or 0 if there is no usable entry
+    unsigned int load(uint64_t key);
+
+    // Saves a linked program. It must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+    void store(uint64_t key, unsigned int program);
+
+    struct Stats
+    {
+        unsigned int hits = 0;
+        unsigned int misses = 0;   // No entry (compiled, then stored)
+        unsigned int rejected = 0; // Entry found but the driver refused it
+    };
+    const Stats &getStats();
+}
+
+#endif // PROGRAM_CACHE_H
@@ -0,0 +1,28 @@
+#ifndef QUAD_INDEX_BUFFER_H
+#define QUAD_INDEX_BUFFER_H
+
+#include <cstddef>
+
+// One GL index buffer shared by every quad mesh. Block faces are always quads of 4 vertices
+// drawn as the triangles (0, 1, 2) and (0, 2, 3), so the indices are the same for every
+// chunk; they are generated once here instead of stored per chunk.
+// 16-bit indices cover 65536 vertices (16384 quads), more than a full chunk can have.
+class QuadIndexBuffer
+{
+public:
+    static const size_t kMaxQuads = 65536 / 4;
+
+    QuadIndexBuffer();
+    ~QuadIndexBuffer();
+
+    // Prevent copying/assignment (owns the GL buffer)
+    QuadIndexBuffer(const QuadIndexBuffer &) = delete;
+    QuadIndexBuffer &operator=(const QuadIndexBuffer &) = delete;
+
+    unsigned int getBufferId() const { return EBO_; }
+
+private:
+    unsigned int EBO_ = 0;
+};
+
+#endif // QUAD_INDEX_BUFFER_H
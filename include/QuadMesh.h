@@ -0,0 +1,34 @@
+#ifndef QUAD_MESH_H
+#define QUAD_MESH_H
+
+#include <cstddef>
+
+struct PackedQuad;
+class QuadIndexBuffer;
+
+// Chunk geometry for the vertex-pulling path: one PackedQuad per face in a buffer texture and
+// no vertex attributes at all. The VAO only holds the shared quad index buffer, so the draw
+// visits vertex IDs quad * 4 + corner and quads.vs fetches the quad's record with texelFetch
+// to build the corner. Each face costs 8 bytes of GPU memory instead of 4 full vertices.
+class QuadMesh
+{
+public:
+    unsigned int VAO = 0;
+    unsigned int buffer = 0;  // GL_TEXTURE_BUFFER storage holding the quads
+    unsigned int texture = 0; // GL_RG32UI buffer texture viewing 'buffer'
+    unsigned int quadCount = 0;
+
+    // Throws if quadCount exceeds QuadIndexBuffer::kMaxQuads
+    QuadMesh(const PackedQuad *quads, size_t quadCount, const QuadIndexBuffer &quadIndices);
+    ~QuadMesh();
+
+    // Prevent copying/assignment (owns GL objects)
+    QuadMesh(const QuadMesh &) = delete;
+    QuadMesh &operator=(const QuadMesh &) = delete;
+
+    // Binds the VAO and the quad texture to 'textureUnit' (the unit quads.vs samples)
+    void bind(unsigned int textureUnit) const;
+    void unbind() const;
+};
+
+#endif // QUAD_MESH_H
@@ -3,20 +3,56 @@
 
 #include "Mesh.h"
 #include "Shader.h"
-#include "World.h"
 #include "Camera.h"
+#include "InstanceBuffer.h"
+#include "GpuTimer.h"
+#include "FrameUniforms.h"
+#include "FrameStats.h"
+#include <vector>
+
+class QuadMesh;
 
 // Handles the rendering process
 class Renderer
 {
 private:
-    const Mesh &meshToDraw;    // Reference to the shared mesh (e.g., cube mesh)
-    const Shader &shaderToUse; // Reference to the shared shader
+    const Shader *shaderToUse; // Chunk shader variant in use (setShader)
+
+    // GPU time of each pass (GpuPass order). Every pass is bracketed every frame, even when it
+    // draws nothing, so the query rings of all passes stay in step.
+    GpuTimer passTimers_[static_cast<int>(GpuPass::Count)];
+
+    FrameUniforms frameUniforms_; // Camera block every program reads (written by beginFrame)
+
+    void clearFrame();
+    // Sets 'model' and its normal matrix (inverse-transpose, computed here once per draw
+    // rather than per vertex in the shader). Not needed for IDENTITY_MODEL variants.
+    void setModelMatrix(const Shader &shader, const glm::mat4 &model);
 
 public:
-    Renderer(const Mesh &mesh, const Shader &shader);
+    Renderer(const Shader &shader);
+
+    // Switches the chunk shader, e.g. to another variant from ShaderVariants
+    void setShader(const Shader &shader) { shaderToUse = &shader; }
+
+    // Writes the per-frame uniform block (camera matrices and position, time, fog) once for
+    // every pass and program of the frame. Call before any of the render functions.
+    void beginFrame(const Camera &camera, double timeSeconds, const glm::vec4 &fogColor, const glm::vec2 &fogRange);
+
+    // Clears the frame and draws every mesh in 'meshes' (the world's chunk meshes)
+    void render(unsigned int textureId, const std::vector<const Mesh *> &meshes);
+
+    // Vertex-pulling variant of render(): clears the frame and draws every quad mesh with
+    // 'quadShader' (assets/shaders/quads.vs), which builds the vertices from the quad records
+    void renderQuads(const Shader &quadShader, unsigned int textureId, const std::vector<const QuadMesh *> &meshes);
+
+    // Reads the pass times that finished on the GPU (a few frames late, never stalls) into
+    // timing.gpuPassMs, and their sum into timing.gpuFrameMs when every pass reported
+    void collectPassTimes(FrameTiming &timing);
 
-    void render(const World &world, const Camera &camera, unsigned int textureId);
+    // Draws every instance in 'instances' of 'mesh' with a single instanced draw call.
+    // The instance buffer must already be attached to the mesh (InstanceBuffer::attachTo).
+    void renderInstanced(const Mesh &mesh, const InstanceBuffer &instances, const Shader &shader, unsigned int textureId);
 };
 
 #endif
\ No newline at end of file
@@ -1,7 +1,9 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 // Helper function to read shader source code from a file
@@ -16,20 +18,60 @@ class Shader
 public:
     unsigned int ID; // The OpenGL shader program ID
 
-    // Constructor reads, compiles, and links shaders
-    Shader(const std::string &vertexPath, const std::string &fragmentPath);
+    // Constructor reads (see preprocessShader: #include and 'defines'), compiles, and links
+    // shaders. Each entry of 'defines' ("NAME" or "NAME value") becomes a #define in both
+    // stages, so one source file can be compiled into variants specialized at compile time.
+    Shader(const std::string &vertexPath, const std::string &fragmentPath, const std::vector<std::string> &defines = {});
 
     // Destructor to clean up the shader program
     ~Shader();
 
+    // Prevent copying/assignment (owns GL program objects)
+    Shader(const Shader &) = delete;
+    Shader &operator=(const Shader &) = delete;
+
     // Use the shader program
     void use() const;
 
+    // Hot reload. beginReload() compiles the current files into a second program without
+    // waiting for the driver (in parallel where GL_KHR_parallel_shader_compile is available);
+    // applyReload(), called at a frame boundary, swaps it in once it is ready. ID changes but
+    // the Shader object stays the same, so references to it remain valid. A program that fails
+    // to compile or link is reported and dropped, and the old one stays in use.
+    bool dependsOn(const std::string &fileName) const; // File name without directory, includes count too
+    void beginReload();
+    bool applyReload(); // True if a new program was swapped in
+
+    // Whether this variant was compiled with the given #define name
+    bool hasDefine(const std::string &name) const;
+
     // Utility uniform functions (add more as needed)
     void setMatrix4(const std::string &name, const glm::mat4 &matrix) const;
+    void setMatrix3(const std::string &name, const glm::mat3 &matrix) const;
     void setVec3(const std::string &name, const glm::vec3 &value) const;
     void setFloat(const std::string &name, float value) const;
     void setInt(const std::string &name, int value) const;
+
+private:
+    std::string vertexPath_;
+    std::string fragmentPath_;
+    std::vector<std::string> defines_;
+    std::vector<std::string> vertexFiles_;   // Files each stage was read from (main file first)
+    std::vector<std::string> fragmentFiles_;
+
+    // Program being rebuilt by a reload; all 0 when none is in flight
+    struct PendingProgram
+    {
+        unsigned int program = 0;
+        unsigned int vertex = 0; // 0 for a program that came from ProgramCache
+        unsigned int fragment = 0;
+        uint64_t cacheKey = 0;
+    };
+    PendingProgram pending_;
+
+    // Setup every linked program needs, whether it was compiled or loaded from ProgramCache
+    void finishLink();
+    void discardPending();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <string>
+#include <vector>
+
+// Shader source after include resolution, as handed to glShaderSource
+struct PreprocessedShader
+{
+    std::string source;             // Empty if a file could not be read
+    std::vector<std::string> files; // Every file read; the index is the GLSL source string number
+};
+
+// Loads a shader stage the way GLSL itself cannot:
+//  - '#include "name"' lines are replaced by that file (relative to the including file).
+//    A file is pasted at most once per stage, so shared headers need no include guards.
+//  - Each entry of 'defines' ("NAME" or "NAME value") becomes a #define right after the
+//    #version line, which is how Shader compiles one source into specialized variants.
+// '#line' directives keep compiler messages pointing at the original file and line; the
+// "N:" in front of a message is the index into 'files'.
+PreprocessedShader preprocessShader(const std::string &path, const std::vector<std::string> &defines);
+
+#endif // SHADER_PREPROCESSOR_H
@@ -0,0 +1,40 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Shader;
+
+// Every program the renderer has asked for, one per (vertex file, fragment file, #define set).
+// A variant is compiled the first time it is requested (or loaded by ProgramCache) and kept
+// for the rest of the run, so switching a feature back and forth costs nothing after the
+// first switch. Pointers stay valid until clear(); hot reload swaps programs inside them.
+class ShaderVariants
+{
+public:
+    ShaderVariants();
+    ~ShaderVariants();
+
+    // Prevent copying/assignment (owns the programs)
+    ShaderVariants(const ShaderVariants &) = delete;
+    ShaderVariants &operator=(const ShaderVariants &) = delete;
+
+    // The order of 'defines' does not matter. A variant that failed to build is returned too
+    // (ID 0) rather than recompiled on every request.
+    Shader &get(const std::string &vertexPath, const std::string &fragmentPath, std::vector<std::string> defines = {});
+
+    // Starts recompiling every variant that reads one of 'changedFiles' (file names without
+    // directory), and swaps in any that finished. Call once per frame, between frames.
+    void reloadChanged(const std::vector<std::string> &changedFiles);
+
+    size_t size() const { return programs_.size(); }
+    void clear(); // Deletes every program (needs the GL context)
+
+private:
+    std::map<std::string, std::unique_ptr<Shader>> programs_;
+};
+
+#endif // SHADER_VARIANTS_H
@@ -0,0 +1,37 @@
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reports files in a directory that were written since the last poll, for shader hot reload.
+// Linux uses inotify, so polling is a single non-blocking read. Elsewhere the modification
+// times of the files are compared, at most a few times per second.
+class ShaderWatcher
+{
+public:
+    explicit ShaderWatcher(const std::string &directory);
+    ~ShaderWatcher();
+
+    // Prevent copying/assignment (owns the inotify descriptor)
+    ShaderWatcher(const ShaderWatcher &) = delete;
+    ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+
+    // Names (not paths) of the files changed since the last call, each listed once
+    std::vector<std::string> poll();
+
+private:
+    std::string directory_;
+    int inotifyFd_ = -1; // -1 when inotify is unavailable
+
+    // Modification-time fallback
+    std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes_;
+    std::chrono::steady_clock::time_point lastScan_;
+
+    void scan(std::vector<std::string> *changed);
+};
+
+#endif // SHADER_WATCHER_H
@@ -0,0 +1,116 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MeshData.h"
+#include "InstanceBuffer.h" // InstanceData
+
+class Camera;
+class JobSystem;
+
+// CPU copy of the block texture array, one entry per mip level.
+// Texels are RGBA8 (4 bytes in memory order R, G, B, A), layer-major, bottom row first like GL.
+struct SoftwareTexture
+{
+    struct Level
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint32_t> texels; // layers * height * width
+    };
+
+    int layers = 0;
+    std::vector<Level> levels;
+};
+
+// Timing of the software rasterizer, accumulated until resetStats()
+struct SoftwareRenderStats
+{
+    size_t frames = 0;
+    size_t triangles = 0;   // Triangles that survived clipping and culling
+    double setupMs = 0.0;   // Vertex transform, clipping, triangle setup and binning
+    double rasterMs = 0.0;  // Tile rasterization (all threads)
+    double megapixels = 0.0; // Framebuffer pixels shaded or cleared, in millions
+};
+
+// Rasterizes MeshData on the CPU into an RGBA8 color buffer, mirroring what Renderer and
+// the block shaders draw with OpenGL: depth test (GL_LESS), back-face culling of CW
+// triangles, near/far clipping, and nearest-neighbor sampling of the texture array
+// (mip level picked per triangle, as GL_NEAREST_MIPMAP_NEAREST would per pixel).
+//
+// Triangles are set up and binned into 64x64 pixel tiles on the calling thread; endFrame()
+// then rasterizes the tiles in parallel on the engine's JobSystem. Each tile is one job that
+// walks its triangles in submission order, so the image does not depend on the thread count.
+class SoftwareRenderer
+{
+public:
+    // Tiles are rasterized on 'jobs', which must outlive the renderer
+    explicit SoftwareRenderer(JobSystem &jobs);
+
+    void setTexture(SoftwareTexture texture) { texture_ = std::move(texture); }
+
+    // Starts a frame: resizes the buffers if needed and clears them (same clear color as Renderer)
+    void beginFrame(int width, int height, const Camera &camera);
+
+    // Queues world-space meshes (identity model matrix, like Renderer::render)
+    void drawMeshes(const std::vector<const MeshData *> &meshes);
+
+    // Queues one copy of 'mesh' per instance, like Renderer::renderInstanced
+    void drawInstances(const MeshData &mesh, const std::vector<InstanceData> &instances);
+
+    // Rasterizes everything queued since beginFrame()
+    void endFrame();
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    unsigned int getThreadCount() const;
+
+    // width * height RGBA8 pixels, bottom row first (ready for glTexSubImage2D)
+    const std::vector<uint32_t> &getColorBuffer() const { return color_; }
+
+    const SoftwareRenderStats &getStats() const { return stats_; }
+    void resetStats() { stats_ = SoftwareRenderStats(); }
+    // Prints per-frame averages and the cost per megapixel
+    void reportStats(std::ostream &out) const;
+
+private:
+    // Screen-space triangle ready for rasterization. Every interpolated value is stored as
+    // a plane equation value(px, py) = dx * px + dy * py + c over pixel centers.
+    struct Triangle
+    {
+        float edgeA[3], edgeB[3], edgeC[3]; // Edge functions, positive inside
+        bool edgeTopLeft[3];                // Edge owns pixels exactly on it (fill rule)
+        float z[3];                         // Window depth (affine in screen space)
+        float invW[3];                      // 1/w, u/w and v/w for perspective-correct UVs
+        float uOverW[3];
+        float vOverW[3];
+        int layer;
+        int mipLevel;
+        int minX, minY, maxX, maxY; // Pixel bounds, clamped to the framebuffer
+    };
+
+    JobSystem &jobs_;
+    int width_ = 0;
+    int height_ = 0;
+    int depthStride_ = 0; // Row length of the depth buffer, padded to a multiple of 4 for SIMD loads
+    int tilesX_ = 0;
+    int tilesY_ = 0;
+    std::vector<uint32_t> color_;
+    std::vector<float> depth_;
+    std::vector<Triangle> triangles_;
+    std::vector<std::vector<uint32_t>> bins_; // Triangle indices per tile, in submission order
+    glm::mat4 viewProjection_ = glm::mat4(1.0f);
+    SoftwareTexture texture_;
+    SoftwareRenderStats stats_;
+    double frameSetupMs_ = 0.0;
+
+    void submitMesh(const MeshData &mesh, const glm::mat4 &mvp, float layerOverride);
+    void setupTriangle(const glm::vec4 clip[3], const glm::vec2 uv[3], int layer);
+    void rasterizeTile(int tile);
+};
+
+#endif // SOFTWARE_RENDERER_H
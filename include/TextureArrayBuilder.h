@@ -0,0 +1,45 @@
+#ifndef TEXTURE_ARRAY_BUILDER_H
+#define TEXTURE_ARRAY_BUILDER_H
+
+#include <string>
+#include <vector>
+
+// Builds a GL_TEXTURE_2D_ARRAY from any number of same-sized images, one layer each.
+//
+// Every image is loaded as RGBA8. The mip chain is computed on the CPU rather than with
+// glGenerateMipmap: colors are averaged in linear light and weighted by alpha (so transparent
+// texels do not bleed their color), and layers with transparent texels (cutouts such as
+// leaves) get their mip alpha rescaled so the fraction of texels passing a 0.5 alpha test
+// stays the same at every level; otherwise cutouts thin out and vanish in the distance.
+// The texture gets immutable storage with exactly the levels down to 1x1 where the context
+// supports it (GL 4.2 / ARB_texture_storage).
+class TextureArrayBuilder
+{
+public:
+    // Loads an image as the next layer and returns its layer index. Throws std::runtime_error
+    // if it cannot be read or its size differs from the first layer's.
+    int addLayer(const std::string &path);
+
+    int getLayerCount() const { return static_cast<int>(layers_.size()); }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int getLevelCount() const; // Mip levels down to 1x1
+
+    // Generates the mips and uploads everything into a new texture, left bound to unit 0.
+    // Throws std::runtime_error if there are no layers or the GL limits are exceeded.
+    unsigned int build() const;
+
+private:
+    struct Layer
+    {
+        std::string path;
+        std::vector<unsigned char> rgba; // width_ * height_ * 4, bottom row first like GL
+        bool cutout = false;             // Has texels with alpha below 255
+    };
+
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<Layer> layers_;
+};
+
+#endif // TEXTURE_ARRAY_BUILDER_H
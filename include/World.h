@@ -3,13 +3,23 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <iostream> // Included for error reporting in getIndex
+#include <glm/glm.hpp>
 
 const int WORLD_WIDTH = 16;
 const int WORLD_HEIGHT = 16;
 const int WORLD_DEPTH = 16;
 const int WORLD_VOLUME = WORLD_WIDTH * WORLD_HEIGHT * WORLD_DEPTH;
 
+// The world is split into cubic chunks for change tracking and meshing.
+// World dimensions must be multiples of CHUNK_SIZE.
+const int CHUNK_SIZE = 8;
+const int CHUNKS_X = WORLD_WIDTH / CHUNK_SIZE;
+const int CHUNKS_Y = WORLD_HEIGHT / CHUNK_SIZE;
+const int CHUNKS_Z = WORLD_DEPTH / CHUNK_SIZE;
+const int CHUNK_COUNT = CHUNKS_X * CHUNKS_Y * CHUNKS_Z;
+
 enum class BlockType : uint8_t
 {
     AIR = 0,
@@ -23,12 +33,25 @@ enum class BlockType : uint8_t
     OAK_LEAF = 8,
 };
 
+// A box of blocks copied out of the world, stored in the same x-fastest row order
+struct BlockRegion
+{
+    glm::ivec3 size = glm::ivec3(0);
+    std::vector<BlockType> blocks;
+};
+
 class World
 {
 private:
     std::vector<BlockType> blocks;
+    std::vector<uint8_t> dirtyChunks; // One flag per chunk, set when its blocks change
     int getIndex(int x, int y, int z) const;
 
+    // Clamps an inclusive [min, max] box to the world bounds. Returns false if nothing is left.
+    static bool clipRegion(glm::ivec3 &min, glm::ivec3 &max);
+    // Flags every chunk overlapping the (already clipped) box, each exactly once
+    void markRegionDirty(const glm::ivec3 &min, const glm::ivec3 &max);
+
 public:
     World();
     void addBlock(int x, int y, int z, BlockType BlockType);
@@ -41,6 +64,33 @@ public:
     bool isSolid(int x, int y, int z) const;
     // ----------------------------
 
+    // Batched isSolid for 'count' coordinates, written as 0/1 into 'out'.
+    // Branch-free, for systems that test many unrelated positions per tick.
+    void isSolidBatch(const int *xs, const int *ys, const int *zs, uint8_t *out, size_t count) const;
+    // Batched test of the 2x2 cells (x0 or x1, y, z0 or z1), e.g. under a box's footprint:
+    // 'out' is 1 where any of the four is solid.
+    void anySolidBatch(const int *x0s, const int *x1s, const int *ys, const int *z0s, const int *z1s, uint8_t *out, size_t count) const;
+
+    // --- Bulk edits ---
+    // All regions are inclusive [min, max] boxes and are clipped to the world bounds.
+    // They work a whole row of blocks at a time and mark each touched chunk dirty once.
+
+    // Set every block in the box to 'type'
+    void fillRegion(const glm::ivec3 &min, const glm::ivec3 &max, BlockType type);
+    // Change every 'from' block in the box to 'to'
+    void replaceInRegion(const glm::ivec3 &min, const glm::ivec3 &max, BlockType from, BlockType to);
+    // Copy the box out of the world (out-of-bounds parts are dropped)
+    BlockRegion copyRegion(const glm::ivec3 &min, const glm::ivec3 &max) const;
+    // Write a copied region back with its minimum corner at 'origin'.
+    // With skipAir, air in the region leaves the existing blocks untouched.
+    void pasteRegion(const BlockRegion &region, const glm::ivec3 &origin, bool skipAir = false);
+
+    // --- Chunk change tracking ---
+    bool isChunkDirty(int cx, int cy, int cz) const;
+    bool hasDirtyChunks() const;
+    void clearChunkDirty(int cx, int cy, int cz);
+    void clearDirtyChunks();
+
     // getBlocksToRender is not implemented as requested
     // const std::vector<glm::vec3> &getBlocksToRender() const;
 };
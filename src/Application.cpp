@@ -2,18 +2,36 @@
 #include "Window.h" // Need full definition now
 #include "Shader.h"
 #include "Mesh.h"
+#include "QuadIndexBuffer.h"
+#include "QuadMesh.h"
 #include "Renderer.h"
 #include "Camera.h" // Include Camera.h
 #include "World.h"  // Include World.h
 #include "MeshBuilder.h"
 #include "MeshData.h"
+#include "InstanceBuffer.h"
+#include "Profiler.h"
+#include "GpuTimer.h"
+#include "GLState.h"
+#include "ProgramCache.h"
+#include "ShaderWatcher.h"
+#include "ShaderVariants.h"
+#include "HeadlessContext.h"
+#include "SoftwareRenderer.h"
+#include "JobSystem.h"
+#include "Arena.h"
+#include "GoldenImages.h"
+#include "TextureArrayBuilder.h"
 #include "glm/geometric.hpp"
 #include "glm/common.hpp"
 #include "glm/trigonometric.hpp"
+#include "glm/ext/matrix_transform.hpp"
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
-#include <OpenGL/gl.h>
+#include "GLPlatform.h"
 #include <exception>
 #include <iostream>
 #include <memory>
@@ -22,26 +40,50 @@
 #include <stdexcept>    // For runtime_error
 #include <chrono>       // For delta time calculation
 #include <GLFW/glfw3.h> // Include the GLFW header
-#include "stb_image.h"
-
-#ifdef __APPLE__
-#include <OpenGL/gl3.h>
-#endif
 
 namespace
 {
     constexpr bool kVSyncEnabled = false;
+    // Fixed physics delta time step for simulation consistency (also stored in input recordings)
+    constexpr double kFixedTimestep = 0.01;
+
+    double millisecondsSince(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // Main-thread task time per frame; uploads past it wait for the next frame
+    constexpr double kMainThreadTaskBudgetMs = 2.0;
+
+    // Golden images are rendered at a fixed size so they do not depend on the window
+    constexpr int kGoldenWidth = 320;
+    constexpr int kGoldenHeight = 240;
+    // Pixels count as different above this perceptual distance (0-1); small enough to catch a
+    // wrong texture layer, large enough to ignore rounding differences between GL drivers
+    constexpr double kGoldenPixelThreshold = 0.1;
+    // A case fails when more than this share of its pixels differ. The software rasterizer picks
+    // one mip level per triangle, which moves up to ~1% of the pixels of grazing floor views
+    // away from GL, so both backends can be checked against the same goldens.
+    constexpr double kGoldenMaxDifferingPercent = 2.0;
+    constexpr int kGoldenTimedFrames = 20;
+    // Warn when a case renders this much slower than its stored timing
+    constexpr double kGoldenSlowdownWarning = 1.25;
 }
 
 // --- Application Implementation ---
 
-Application::Application()
-    : camera_(glm::vec3(5.0f, 5.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f, 800.0f / 600.0f, 0.1f, 100.0f) // Initialize camera here
+Application::Application(const AppConfig &config)
+    : config_(config),
+      camera_(glm::vec3(5.0f, 5.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f, 800.0f / 600.0f, 0.1f, 100.0f), // Initialize camera here
+      player_(glm::vec3(5.0f, 3.0f, 5.0f)) // Spawn above the floor, below the initial camera
 {
     glm::vec3 front = glm::normalize(camera_.target - camera_.position);
     yaw_ = glm::degrees(atan2(front.z, front.x));
     pitch_ = glm::degrees(asin(front.y));
 
+    lodBaseDistance_ = config_.lodDistance;
+    chunkRebuildsPerLod_.assign(MeshBuilder::LOD_LEVELS, 0);
+
     std::cout << "Application created." << std::endl;
 }
 
@@ -54,6 +96,11 @@ Application::~Application()
 bool Application::initialize()
 {
     std::cout << "Initializing Application..." << std::endl;
+
+    // One set of worker threads for every parallel subsystem (meshing, software rasterizer)
+    jobs_ = std::make_unique<JobSystem>();
+    std::cout << "Job system started (" << jobs_->getThreadCount() << " threads)." << std::endl;
+
     if (!initWindow())
         return false;
     if (!initOpenGL())
@@ -63,15 +110,36 @@ bool Application::initialize()
 
     if (!loadResources())
         return false;
+
+    // Input recording / replay for repeatable benchmark runs
+    try
+    {
+        if (!config_.replayInputPath.empty())
+        {
+            inputPlayback_ = std::make_unique<InputPlayback>(config_.replayInputPath, kFixedTimestep);
+            std::cout << "Replaying " << inputPlayback_->frameCount() << " recorded frames from " << config_.replayInputPath << std::endl;
+        }
+        else if (!config_.recordInputPath.empty())
+        {
+            inputRecorder_ = std::make_unique<InputRecorder>(config_.recordInputPath, kFixedTimestep);
+            std::cout << "Recording input to " << config_.recordInputPath << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Input recording setup failed: " << e.what() << std::endl;
+        return false;
+    }
+
     std::cout << "Application initialized successfully." << std::endl;
     return true;
 }
 
 void Application::run()
 {
-    if (!window_)
+    if (!window_ && !headless_)
     {
-        std::cerr << "Cannot run application without a window." << std::endl;
+        std::cerr << "Cannot run application without a window or headless context." << std::endl;
         return;
     }
 
@@ -79,19 +147,29 @@ void Application::run()
     // Simple delta time calculation
     auto lastFrameTime = std::chrono::high_resolution_clock::now();
 
-    // Reset FPS counters when starting the loop (just in case run() is called multiple times)
-    frameCount_ = 0;
-    double totalTime_ = 0.0;
-    double timeSinceLastPrint_ = 0.0;
+    // Reset frame stats when starting the loop (just in case run() is called multiple times)
+    frameStats_.reset();
+    jobs_->resetStats();
+    double timeSinceLastPrint = 0.0;
 
-    double t = 0.0;
-    // Fixed physics delta time step for simulation consistency
-    double dt = 0.01;
+    double dt = kFixedTimestep;
 
     double accumulator = 0.0;
 
-    while (!window_->shouldClose())
+    PROFILE_THREAD_NAME("Main");
+
+    int framesRendered = 0;
+    while (!shouldClose())
     {
+        if (config_.maxFrames > 0 && framesRendered >= config_.maxFrames)
+        {
+            std::cout << "Rendered " << framesRendered << " frames, exiting." << std::endl;
+            break;
+        }
+
+        PROFILE_SCOPE("Frame");
+        FrameTiming frameTiming;
+
         // Calculate delta time
         auto currentFrameTime = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> diff = currentFrameTime - lastFrameTime;
@@ -103,35 +181,82 @@ void Application::run()
         lastFrameTime = currentFrameTime;
 
         accumulator += deltaTime;
+        timeSinceLastPrint += diff.count();
 
-        frameCount_++;                    // Increment frame count
-        totalTime_ += deltaTime;          // Add delta time to total
-        timeSinceLastPrint_ += deltaTime; // Add delta time to time since last print
-
-        // Check if 5 seconds have passed
-        if (timeSinceLastPrint_ >= 5.0f)
+        // Every 5 seconds, print frame time percentiles and hitches for the interval
+        if (timeSinceLastPrint >= 5.0)
         {
-            // Calculate average FPS over the accumulated time
-            double averageFPS = (double)frameCount_ / totalTime_; // Ensure float division
-
-            // Print the result
-            std::cout << "Average FPS: " << averageFPS << std::endl;
-
-            // Reset the counters for the next 5-second interval
-            frameCount_ = 0;
-            totalTime_ = 0.0;
-            timeSinceLastPrint_ = 0.0; // Reset the timer
+            const uint64_t intervalFrames = frameStats_.frameCount();
+            frameStats_.report(std::cout, timeSinceLastPrint);
+            frameStats_.reset();
+            if (softwareRenderer_)
+            {
+                softwareRenderer_->reportStats(std::cout);
+                softwareRenderer_->resetStats();
+            }
+            jobs_->reportStats(std::cout);
+            jobs_->resetStats();
+            GLState::reportStats(std::cout, intervalFrames);
+            GLState::resetStats();
+            const MainThreadQueue::Stats &taskStats = mainThreadTasks_.getStats();
+            if (taskStats.executed > 0 || taskStats.coalesced > 0)
+            {
+                std::cout << "  Main thread tasks: " << taskStats.executed << " run, " << taskStats.coalesced << " coalesced, "
+                          << taskStats.deferred << " frames over budget, " << mainThreadTasks_.pendingCount() << " pending" << std::endl;
+            }
+            mainThreadTasks_.resetStats();
+            reportChunkRebuilds(std::cout, "  Chunk re-meshes");
+            timeSinceLastPrint = 0.0;
         }
 
+        if (shaderWatcher_)
+            reloadChangedShaders();
+
         // Update the camera projeciton in case user resizes window, not am defensively setting glViewport again here (is done in callback in Window too)
         int fbW, fbH;
-        glfwGetFramebufferSize(window_->getGLFWwindow(), &fbW, &fbH);
+        if (headless_)
+        {
+            fbW = headless_->getWidth();
+            fbH = headless_->getHeight();
+        }
+        else
+        {
+            glfwGetFramebufferSize(window_->getGLFWwindow(), &fbW, &fbH);
+        }
         glViewport(0, 0, fbW, fbH);
         camera_.aspectRatio = float(fbW) / float(fbH);
+        framebufferWidth_ = fbW;
+        framebufferHeight_ = fbH;
 
         // 1. Input
+        auto stageStart = std::chrono::high_resolution_clock::now();
         processInput();
 
+        // Number of fixed update ticks this frame. A replay runs exactly the recorded
+        // count so the simulation repeats step for step, independent of frame timing.
+        uint32_t ticks = 0;
+        if (inputPlayback_)
+        {
+            InputFrame frame;
+            if (!inputPlayback_->nextFrame(frame))
+            {
+                std::cout << "Replay finished after " << inputPlayback_->frameCount() << " frames." << std::endl;
+                break;
+            }
+            input_ = frame.input;
+            ticks = frame.ticks;
+        }
+        else
+        {
+            while (accumulator >= dt)
+            {
+                accumulator -= dt;
+                ++ticks;
+            }
+        }
+        if (inputRecorder_)
+            inputRecorder_->recordFrame(InputFrame{input_, ticks});
+
         // 1.5 Treat mouse look for camera as real time subsystem, update every frame
         yaw_ += input_.mouseDX * mouseSens_;
         pitch_ += input_.mouseDY * mouseSens_;
@@ -149,15 +274,31 @@ void Application::run()
         // reset mouse deltas for next frame
         input_.mouseDX = input_.mouseDY = 0.0f;
 
+        if (input_.toggleFly)
+        {
+            player_.flying = !player_.flying;
+            player_.velocity = glm::vec3(0.0f);
+            std::cout << "Fly mode " << (player_.flying ? "enabled" : "disabled") << std::endl;
+        }
+        frameTiming.stageMs[static_cast<int>(FrameStage::Input)] = millisecondsSince(stageStart);
+
         // 2. Update Game Logic (fixed physics step consuming the fime "created" by frame)
-        while (accumulator >= dt)
+        stageStart = std::chrono::high_resolution_clock::now();
+        for (uint32_t tick = 0; tick < ticks; ++tick)
         {
             // previousState = currentState;
             // integrate(currentState, t, dt);
             update(static_cast<float>(dt));
-            t += dt;
-            accumulator -= dt;
+            simulationTime_ += dt;
         }
+        frameTiming.stageMs[static_cast<int>(FrameStage::Update)] = millisecondsSince(stageStart);
+
+        // 2.5 Re-mesh chunks whose blocks were edited or whose LOD changed as the camera moved,
+        // then run queued GL work (the uploads of those meshes) for a bounded time
+        stageStart = std::chrono::high_resolution_clock::now();
+        updateChunkMeshes();
+        mainThreadTasks_.drain(kMainThreadTaskBudgetMs);
+        frameTiming.stageMs[static_cast<int>(FrameStage::Meshing)] = millisecondsSince(stageStart);
 
         // EXAMPLE later we can interpolate the render to get the fractional physics step we could not perform in simulation
         // const double alpha = accumulator / dt;
@@ -165,20 +306,226 @@ void Application::run()
         //     previousState * ( 1.0 - alpha );
         // render( state );
 
-        // 3. Render
-        render();
+        // 3. Render (GPU time is measured with timer queries and read back a few frames later).
+        // The GL renderer times each of its passes; timer queries cannot nest, so the whole-frame
+        // query is only used for the software path, whose GPU work is the final blit.
+        stageStart = std::chrono::high_resolution_clock::now();
+        if (softwareRenderer_)
+        {
+            gpuFrameTimer_->begin();
+            render();
+            gpuFrameTimer_->end();
+            frameTiming.gpuFrameMs = gpuFrameTimer_->collect();
+        }
+        else
+        {
+            render();
+            renderer_->collectPassTimes(frameTiming);
+        }
+        frameTiming.stageMs[static_cast<int>(FrameStage::Render)] = millisecondsSince(stageStart);
 
         // 4. Swap Buffers and Poll Events
-        window_->swapBuffers();
-        window_->pollEvents();
+        stageStart = std::chrono::high_resolution_clock::now();
+        presentFrame();
+        frameTiming.stageMs[static_cast<int>(FrameStage::Swap)] = millisecondsSince(stageStart);
+
+        frameTiming.cpuFrameMs = millisecondsSince(currentFrameTime);
+        frameStats_.recordFrame(frameTiming);
+        ++framesRendered;
+    }
+
+    // Report the last partial interval too, a replay usually ends in the middle of one
+    if (frameStats_.frameCount() > 0)
+    {
+        frameStats_.report(std::cout, timeSinceLastPrint);
+        if (softwareRenderer_)
+            softwareRenderer_->reportStats(std::cout);
     }
     std::cout << "Exiting main loop." << std::endl;
 }
 
+bool Application::runGoldenImages()
+{
+    const bool update = config_.updateGolden;
+    const std::string &dir = config_.goldenDir;
+    const std::string backend = softwareRenderer_ ? "software" : (quadShader_ ? "gl-pulling" : "gl");
+    std::cout << (update ? "Updating" : "Checking") << " golden images in " << dir << " (" << backend << " backend)..." << std::endl;
+
+    // Offscreen target; the software path blits into it like it would into the window
+    GLuint fbo = 0, colorBuffer = 0, depthBuffer = 0;
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, kGoldenWidth, kGoldenHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, kGoldenWidth, kGoldenHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    bool passed = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!passed)
+        std::cerr << "Golden images: offscreen framebuffer is incomplete." << std::endl;
+
+    glViewport(0, 0, kGoldenWidth, kGoldenHeight);
+    camera_.aspectRatio = float(kGoldenWidth) / float(kGoldenHeight);
+    framebufferWidth_ = kGoldenWidth;
+    framebufferHeight_ = kGoldenHeight;
+
+    const std::string timingsPath = dir + "/timings.csv";
+    std::map<std::string, double> timings = GoldenImages::readTimings(timingsPath);
+    size_t mismatches = 0;
+    bool sceneBuilt = false;
+    GoldenImages::Scene builtScene = GoldenImages::Scene::DEFAULT;
+
+    for (const GoldenImages::Case &goldenCase : GoldenImages::cases())
+    {
+        if (!passed)
+            break;
+
+        // Rebuild the world only when the scene changes; no update ticks run, so entities stay where they spawned
+        if (!sceneBuilt || goldenCase.scene != builtScene)
+        {
+            gameWorld_ = World();
+            entities_.clear();
+            switch (goldenCase.scene)
+            {
+            case GoldenImages::Scene::DEFAULT:
+                setupScene();
+                break;
+            case GoldenImages::Scene::TERRAIN:
+                GoldenImages::buildTerrainScene(gameWorld_);
+                break;
+            case GoldenImages::Scene::STRESS:
+                GoldenImages::buildStressScene(gameWorld_);
+                break;
+            }
+            sceneBuilt = true;
+            builtScene = goldenCase.scene;
+        }
+
+        camera_.position = goldenCase.eye;
+        camera_.target = goldenCase.target;
+        lodBaseDistance_ = goldenCase.lodDistance > 0.0f ? goldenCase.lodDistance : config_.lodDistance;
+        if (!updateChunkMeshes())
+        {
+            passed = false;
+            break;
+        }
+        mainThreadTasks_.drainAll();
+        reportChunkRebuilds(std::cout, std::string("  ") + goldenCase.name + " meshed");
+
+        // One untimed warm-up frame, then the median of the timed ones (glFinish so the GPU work is included)
+        std::vector<double> frameMs;
+        for (int frame = 0; frame <= kGoldenTimedFrames; ++frame)
+        {
+            auto frameStart = std::chrono::high_resolution_clock::now();
+            render();
+            glFinish();
+            if (frame > 0)
+                frameMs.push_back(millisecondsSince(frameStart));
+        }
+        std::sort(frameMs.begin(), frameMs.end());
+        double medianMs = frameMs[frameMs.size() / 2];
+
+        // Read back top row first, as PNG stores it
+        GoldenImages::RgbImage image;
+        image.width = kGoldenWidth;
+        image.height = kGoldenHeight;
+        image.pixels.resize(static_cast<size_t>(kGoldenWidth) * kGoldenHeight * 3);
+        const size_t rowBytes = static_cast<size_t>(kGoldenWidth) * 3;
+        std::vector<uint8_t> rows(image.pixels.size());
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo); // renderSoftware() rebinds the read framebuffer
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, kGoldenWidth, kGoldenHeight, GL_RGB, GL_UNSIGNED_BYTE, rows.data());
+        for (int y = 0; y < kGoldenHeight; ++y)
+            std::copy_n(rows.begin() + (kGoldenHeight - 1 - y) * rowBytes, rowBytes, image.pixels.begin() + y * rowBytes);
+
+        const std::string imagePath = dir + "/" + goldenCase.name + ".png";
+        const std::string timingKey = std::string(goldenCase.name) + "/" + backend;
+        if (update)
+        {
+            if (!GoldenImages::writePng(imagePath, image))
+            {
+                std::cerr << "Golden images: could not write " << imagePath << std::endl;
+                passed = false;
+                break;
+            }
+            timings[timingKey] = medianMs;
+            std::cout << "  " << goldenCase.name << ": wrote " << imagePath << " (" << medianMs << " ms/frame)" << std::endl;
+            continue;
+        }
+
+        GoldenImages::RgbImage golden;
+        if (!GoldenImages::readPng(imagePath, golden))
+        {
+            std::cerr << "  " << goldenCase.name << ": missing golden " << imagePath << " (create it with --update-golden)" << std::endl;
+            ++mismatches;
+            continue;
+        }
+
+        GoldenImages::Difference difference = GoldenImages::compareImages(image, golden, kGoldenPixelThreshold);
+        bool matches = difference.differingPercent <= kGoldenMaxDifferingPercent;
+        std::cout << "  " << goldenCase.name << ": " << (matches ? "ok" : "MISMATCH")
+                  << " (" << difference.differingPixels << " pixels / " << difference.differingPercent << "% differ, max delta "
+                  << difference.maxDelta << "), " << medianMs << " ms/frame";
+        auto stored = timings.find(timingKey);
+        if (stored != timings.end())
+        {
+            std::cout << " vs " << stored->second << " ms stored";
+            if (medianMs > stored->second * kGoldenSlowdownWarning)
+                std::cout << " [SLOWER]";
+        }
+        std::cout << std::endl;
+
+        if (!matches)
+        {
+            // Keep what was rendered next to the golden for inspection
+            ++mismatches;
+            GoldenImages::writePng(dir + "/" + goldenCase.name + ".actual.png", image);
+        }
+    }
+
+    lodBaseDistance_ = config_.lodDistance;
+
+    if (passed && update && !GoldenImages::writeTimings(timingsPath, timings))
+    {
+        std::cerr << "Golden images: could not write " << timingsPath << std::endl;
+        passed = false;
+    }
+
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    if (headless_)
+        headless_->bindFramebuffer();
+    else
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (mismatches > 0)
+    {
+        std::cerr << mismatches << " golden image(s) did not match." << std::endl;
+        passed = false;
+    }
+    else if (passed)
+    {
+        std::cout << "Golden images " << (update ? "updated." : "match.") << std::endl;
+    }
+    return passed;
+}
+
 bool Application::initWindow()
 {
     try
     {
+        if (config_.headless)
+        {
+            // No display: render into an offscreen framebuffer of the usual window size
+            headless_ = std::make_unique<HeadlessContext>(800, 600);
+            return true;
+        }
         // Use smart pointer for automatic memory management
         window_ = std::make_unique<Window>(800, 600, "OpenGL Cube World - Refactored", kVSyncEnabled);
         // Window constructor handles GLFW init, window creation, context, and GLAD (if used)
@@ -196,16 +543,27 @@ bool Application::initOpenGL()
     // Ensure this is called *after* the OpenGL context is created and made current
 
     // --- Current State ---
-    glEnable(GL_DEPTH_TEST); // Keep depth testing enabled
+    GLState::setEnabled(GL_DEPTH_TEST, true); // Keep depth testing enabled
 
     // --- ADD THESE LINES ---
-    glEnable(GL_CULL_FACE); // Enable face culling
+    GLState::setEnabled(GL_CULL_FACE, true); // Enable face culling
     glCullFace(GL_BACK);    // Tell OpenGL to cull back-facing triangles
     glFrontFace(GL_CCW);    // Define CCW winding order as front-facing (this is the default and matches your MeshBuilder)
     // ---------------------
 
     // Set clear color (can also be done per-frame in render)
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    GLState::setClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+
+    // GPU frame timing (timer queries), reported alongside the CPU frame stats
+    gpuFrameTimer_ = std::make_unique<GpuTimer>();
+    if (!gpuFrameTimer_->isSupported())
+    {
+        std::cout << "GL timer queries unavailable, GPU frame times will not be reported." << std::endl;
+    }
+    if (!config_.hitchThresholdsMs.empty())
+        frameStats_.setHitchThresholds(config_.hitchThresholdsMs);
+    if (!config_.frameStatsPath.empty())
+        frameStats_.openSink(config_.frameStatsPath);
 
     std::cout << "OpenGL state initialized (Depth Test & Back-Face Culling enabled)." << std::endl; // Updated message
     return true;                                                                                    // Add error checking if needed
@@ -214,11 +572,11 @@ bool Application::initOpenGL()
 bool Application::loadResources()
 {
     std::cout << "Loading resources..." << std::endl;
-    // Load Shaders
+    // Load Shaders (linked programs from earlier runs come from the binary cache)
+    ProgramCache::setDirectory(config_.shaderCacheDir);
     try
     {
-        blockShader_ = std::make_unique<Shader>("assets/shaders/shader.vs", "assets/shaders/shader.fs");
-        if (blockShader_->ID == 0)
+        if (!selectShaderVariants())
         {
             throw std::runtime_error("Shader compilation/linking failed.");
         }
@@ -230,194 +588,38 @@ bool Application::loadResources()
         return false;
     }
 
-    // Load Texture
-
-    int dirt = 0;
-    int stone = 1;
-    int sand = 2;
-    int grass_top = 3;
-    int grass_side = 4;
-    int wood_oak_top = 5;
-    int wood_oak_side = 6;
-    int cobblestone = 7;
-    int oak_plank = 8;
-    int oak_leaf = 9;
-
-    layer_mapping.emplace(BlockType::DIRT, FaceToLayer{dirt, dirt, dirt, dirt, dirt, dirt});
-    layer_mapping.emplace(BlockType::STONE, FaceToLayer{stone, stone, stone, stone, stone, stone});
-    layer_mapping.emplace(BlockType::SAND, FaceToLayer{sand, sand, sand, sand, sand, sand});
-    layer_mapping.emplace(BlockType::GRASS, FaceToLayer{grass_side, grass_side, grass_top, dirt, grass_side, grass_side});
-    layer_mapping.emplace(BlockType::WOOD_OAK, FaceToLayer{wood_oak_side, wood_oak_side, wood_oak_top, wood_oak_top, wood_oak_side, wood_oak_side});
-    layer_mapping.emplace(BlockType::COBBLESTONE, FaceToLayer{cobblestone, cobblestone, cobblestone, cobblestone, cobblestone, cobblestone});
-    layer_mapping.emplace(BlockType::OAK_PLANK, FaceToLayer{oak_plank, oak_plank, oak_plank, oak_plank, oak_plank, oak_plank});
-    layer_mapping.emplace(BlockType::OAK_LEAF, FaceToLayer{oak_leaf, oak_leaf, oak_leaf, oak_leaf, oak_leaf, oak_leaf});
-
-    glGenTextures(1, &blockTextureArrayId);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, blockTextureArrayId);
-
-    int textureWidth = 16;  // Example
-    int textureHeight = 16; // Example
-    int layerCount = 10;    // Example: dirt, stone, grass_top, grass_side
-    int mipLevelCount = 4;  // Calculate based on size, e.g., log2(max(width, height)) + 1
-
-    glTexImage3D(GL_TEXTURE_2D_ARRAY,
-                 0,                // Base mipmap level for initial definition©
-                 GL_RGB8,          // Internal format (requesting 8 bits per channel RGB)
-                 textureWidth,     // Width
-                 textureHeight,    // Height
-                 layerCount,       // Depth (number of layers)
-                 0,                // Border (must be 0 in core profile)
-                 GL_RGB,           // Format of pixel data (doesn't matter when data is NULL)
-                 GL_UNSIGNED_BYTE, // Type of pixel data (doesn't matter when data is NULL)
-                 NULL);            // Pass NULL data pointer to only allocate storage
-
-    stbi_set_flip_vertically_on_load(true);
-
-    int x, y, n;
-    unsigned char *data = stbi_load("assets/textures/dirt_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    dirt,             // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/stone_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    stone,            // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/sand_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    sand,             // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/grass_top_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    grass_top,        // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/grass_side_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    grass_side,       // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/oak_top_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    wood_oak_top,     // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/oak_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    wood_oak_side,    // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/cobblestone_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    cobblestone,      // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/oak_plank_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    oak_plank,        // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    stbi_image_free(data);
-
-    data = stbi_load("assets/textures/oak_leaf_16x16.png", &x, &y, &n, 0);
-    std::cout << "stb image x: " << x << " y: " << y << " n: " << n << '\n';
-    glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
-                    0,                // Mipmap level (0 is base)
-                    0, 0,             // xoffset, yoffset (always 0 for full layer update)
-                    oak_leaf,         // The layer index to upload to
-                    textureWidth,     // Width of the data being uploaded
-                    textureHeight,    // Height of the data being uploaded
-                    1,                // Depth (always 1 for 2D array layers)
-                    GL_RGB,           // Format of the source data (e.g., from stb_image)
-                    GL_UNSIGNED_BYTE, // Type of the source data
-                    data);            // Pointer to the image data
-    std::cout << "about to free\n";
-    stbi_image_free(data);
-
-    std::cout << "finished loading images\n";
-
-    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    // Load Texture: one array layer per block texture, in the order they are added
+    try
+    {
+        TextureArrayBuilder textures;
+        int dirt = textures.addLayer("assets/textures/dirt_16x16.png");
+        int stone = textures.addLayer("assets/textures/stone_16x16.png");
+        int sand = textures.addLayer("assets/textures/sand_16x16.png");
+        int grass_top = textures.addLayer("assets/textures/grass_top_16x16.png");
+        int grass_side = textures.addLayer("assets/textures/grass_side_16x16.png");
+        int wood_oak_top = textures.addLayer("assets/textures/oak_top_16x16.png");
+        int wood_oak_side = textures.addLayer("assets/textures/oak_16x16.png");
+        int cobblestone = textures.addLayer("assets/textures/cobblestone_16x16.png");
+        int oak_plank = textures.addLayer("assets/textures/oak_plank_16x16.png");
+        int oak_leaf = textures.addLayer("assets/textures/oak_leaf_16x16.png");
+
+        layer_mapping.emplace(BlockType::DIRT, FaceToLayer{dirt, dirt, dirt, dirt, dirt, dirt});
+        layer_mapping.emplace(BlockType::STONE, FaceToLayer{stone, stone, stone, stone, stone, stone});
+        layer_mapping.emplace(BlockType::SAND, FaceToLayer{sand, sand, sand, sand, sand, sand});
+        layer_mapping.emplace(BlockType::GRASS, FaceToLayer{grass_side, grass_side, grass_top, dirt, grass_side, grass_side});
+        layer_mapping.emplace(BlockType::WOOD_OAK, FaceToLayer{wood_oak_side, wood_oak_side, wood_oak_top, wood_oak_top, wood_oak_side, wood_oak_side});
+        layer_mapping.emplace(BlockType::COBBLESTONE, FaceToLayer{cobblestone, cobblestone, cobblestone, cobblestone, cobblestone, cobblestone});
+        layer_mapping.emplace(BlockType::OAK_PLANK, FaceToLayer{oak_plank, oak_plank, oak_plank, oak_plank, oak_plank, oak_plank});
+        layer_mapping.emplace(BlockType::OAK_LEAF, FaceToLayer{oak_leaf, oak_leaf, oak_leaf, oak_leaf, oak_leaf, oak_leaf});
+
+        // Uploads every layer with its full mip chain (generated on the CPU)
+        blockTextureArrayId = textures.build();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Texture Loading Error: " << e.what() << std::endl;
+        return false;
+    }
 
     // Set wrapping parameters for S (horizontal) and T (vertical) texture coordinates
     glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT); // Repeat the texture horizontally
@@ -427,69 +629,286 @@ bool Application::loadResources()
     glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // Use linear interpolation for magnification
     glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
 
-    // Create Mesh
-    MeshData worldMeshData;
+    // Create chunk meshes
+    if (config_.softwareRenderer && !initSoftwareRenderer())
+        return false; // shutdown() releases the shaders
 
     std::cout << "about to generate world mesh\n";
+    if (!softwareRenderer_)
+        quadIndices_ = std::make_unique<QuadIndexBuffer>();
+    chunkMeshes_.clear();
+    chunkMeshes_.resize(CHUNK_COUNT);
+    if (!updateChunkMeshes())
+        return false; // shutdown() releases the shaders
+    mainThreadTasks_.drainAll(); // The first frame should show the whole world
+    reportChunkRebuilds(std::cout, "Built world");
+
+    // Create Renderer (after shader is ready)
+    // Renderer constructor takes a reference, so ensure the Shader exists
+    renderer_ = std::make_unique<Renderer>(*blockShader_);
+    std::cout << "Renderer created." << std::endl;
 
-    MeshBuilder::generateWorldMesh(gameWorld_, worldMeshData, layer_mapping);
-
-    // *** ADD THIS CHECK ***
-    std::cout << "MeshData sizes before interleaving:\n";
-    std::cout << "  Vertices:     " << worldMeshData.vertices.size() << "\n";
-    std::cout << "  Normals:      " << worldMeshData.normals.size() << "\n";
-    std::cout << "  TexCoords:    " << worldMeshData.texCoords.size() << "\n";
-    std::cout << "  LayerIndices: " << worldMeshData.layerIndices.size() << "\n";
-    std::cout << "  Indices:      " << worldMeshData.indices.size() << "\n";
-    assert(worldMeshData.vertices.size() == worldMeshData.normals.size());
-    assert(worldMeshData.vertices.size() == worldMeshData.texCoords.size());
-    assert(worldMeshData.vertices.size() == worldMeshData.layerIndices.size());
-    // *** END ADDED CHECK ***
-
-    std::vector<float> vertices = worldMeshData.getInterleavedVertices();
-
+    // Entity resources: a unit cube centered on the origin, drawn once per entity via instancing
     try
     {
-        worldMesh_ = std::make_unique<Mesh>(vertices.data(),
-                                            vertices.size() * sizeof(float),
-                                            worldMeshData.indices.data(),
-                                            worldMeshData.indices.size() * sizeof(unsigned int),
-                                            worldMeshData.getVertexStride(),
-                                            worldMeshData.attributeLayout);
-        if (worldMesh_->VAO == 0)
-        { // Check if VAO creation failed (though Mesh constructor doesn't explicitly return status)
-            throw std::runtime_error("Mesh VAO creation failed (or Mesh constructor indicated error).");
-        }
-        std::cout << "Cube mesh created successfully." << std::endl;
+        MeshData cubeMeshData;
+        MeshBuilder::appendCube(cubeMeshData, glm::vec3(0.0f), layer_mapping, BlockType::DIRT, 1.0f);
+        entityMeshData_ = cubeMeshData;
+        std::vector<float> cubeVertices = cubeMeshData.getInterleavedVertices();
+        entityMesh_ = std::make_unique<Mesh>(cubeVertices.data(),
+                                             cubeVertices.size() * sizeof(float),
+                                             cubeMeshData.indices.data(),
+                                             cubeMeshData.indices.size() * sizeof(unsigned int),
+                                             cubeMeshData.getVertexStride(),
+                                             cubeMeshData.attributeLayout);
+
+        entityInstances_ = std::make_unique<InstanceBuffer>();
+        entityInstances_->attachTo(*entityMesh_);
+        std::cout << "Entity instancing resources created." << std::endl;
     }
     catch (const std::exception &e)
-    { // Catch potential errors if Mesh throws
-        std::cerr << "Mesh Creation Error: " << e.what() << std::endl;
-        // Clean up already loaded shader if mesh fails
-        blockShader_.reset(); // Release shader ownership
+    {
+        std::cerr << "Entity Resource Error: " << e.what() << std::endl;
         return false;
     }
 
-    // Create Renderer (after mesh and shader are ready)
-    // Renderer constructor takes references, so ensure Mesh and Shader exist
-    renderer_ = std::make_unique<Renderer>(*worldMesh_, *blockShader_);
-    std::cout << "Renderer created." << std::endl;
+    const ProgramCache::Stats &cacheStats = ProgramCache::getStats();
+    std::cout << "Shader programs: " << shaderVariants_.size() << " variants, " << cacheStats.hits << " from cache, " << cacheStats.misses + cacheStats.rejected
+              << " compiled (" << cacheStats.rejected << " cached binaries rejected)." << std::endl;
 
+    if (config_.watchShaders)
+        shaderWatcher_ = std::make_unique<ShaderWatcher>("assets/shaders");
     return true;
 }
 
-void Application::setupScene()
+void Application::reloadChangedShaders()
 {
+    PROFILE_SCOPE("ReloadShaders");
+    // Between frames, so a draw never mixes the old and new program
+    shaderVariants_.reloadChanged(shaderWatcher_->poll());
+}
 
-    std::cout << "Setting up scene..." << std::endl;
+bool Application::selectShaderVariants()
+{
+    // Fragment features shared by every world and entity program
+    std::vector<std::string> features;
+    if (fogEnabled_)
+        features.push_back("FOG");
+    if (debugView_ == DebugView::Normals)
+        features.push_back("DEBUG_VIEW_NORMALS");
+    else if (debugView_ == DebugView::Layers)
+        features.push_back("DEBUG_VIEW_LAYERS");
+
+    std::vector<std::string> chunkFeatures = features;
+    chunkFeatures.push_back("IDENTITY_MODEL");
+    chunkFeatures.push_back("PACKED_NORMAL"); // Chunk vertices are PackedVertex
+    Shader *block = &shaderVariants_.get("assets/shaders/shader.vs", "assets/shaders/shader.fs", chunkFeatures);
+    Shader *quad = config_.vertexPulling ? &shaderVariants_.get("assets/shaders/quads.vs", "assets/shaders/shader.fs", features) : nullptr;
+    Shader *entity = &shaderVariants_.get("assets/shaders/instanced.vs", "assets/shaders/shader.fs", features);
+    if (block->ID == 0 || (quad && quad->ID == 0) || entity->ID == 0)
+        return false;
+
+    blockShader_ = block;
+    quadShader_ = quad;
+    entityShader_ = entity;
+    if (renderer_)
+        renderer_->setShader(*blockShader_);
+    return true;
+}
+
+int Application::selectChunkLod(int cx, int cy, int cz, int currentLod) const
+{
+    // Hysteresis band (fraction of the distance) so chunks on a LOD boundary do not flip every frame
+    constexpr float kLodHysteresis = 0.1f;
+
+    glm::vec3 chunkCenter = (glm::vec3(cx, cy, cz) + 0.5f) * static_cast<float>(CHUNK_SIZE);
+    float distance = glm::length(chunkCenter - camera_.position);
 
-    for (int z = 0; z < 16; ++z)
+    auto lodForDistance = [this](float d)
     {
-        for (int x = 0; x < 16; ++x)
+        int lod = 0;
+        float threshold = lodBaseDistance_;
+        while (lod < MeshBuilder::LOD_LEVELS - 1 && d >= threshold)
         {
-            gameWorld_.addBlock(x, 0, z, BlockType::DIRT);
+            ++lod;
+            threshold *= 2.0f;
         }
+        return lod;
+    };
+
+    int finest = lodForDistance(distance * (1.0f - kLodHysteresis));
+    int coarsest = lodForDistance(distance * (1.0f + kLodHysteresis));
+    if (currentLod >= finest && currentLod <= coarsest)
+        return currentLod;
+    return lodForDistance(distance);
+}
+
+bool Application::updateChunkMeshes()
+{
+    PROFILE_SCOPE("UpdateChunkMeshes");
+
+    // Pick the chunks to rebuild here, then mesh them in parallel; the world does not change
+    // until every job is done because this thread waits for them
+    chunkRebuilds_.clear();
+    for (int cy = 0; cy < CHUNKS_Y; ++cy)
+    {
+        for (int cz = 0; cz < CHUNKS_Z; ++cz)
+        {
+            for (int cx = 0; cx < CHUNKS_X; ++cx)
+            {
+                ChunkRebuild rebuild;
+                rebuild.chunkIndex = (cy * CHUNKS_Z + cz) * CHUNKS_X + cx;
+                rebuild.coords = glm::ivec3(cx, cy, cz);
+                ChunkMesh &chunk = chunkMeshes_[rebuild.chunkIndex];
+                rebuild.lod = selectChunkLod(cx, cy, cz, chunk.lod);
+                rebuild.edited = gameWorld_.isChunkDirty(cx, cy, cz);
+                if (rebuild.lod == chunk.lod && !rebuild.edited)
+                    continue;
+
+                chunk.lod = rebuild.lod;
+                gameWorld_.clearChunkDirty(cx, cy, cz);
+                chunkRebuilds_.push_back(rebuild);
+            }
+        }
+    }
+    if (chunkRebuilds_.empty())
+        return true;
+
+    // One arena per job thread. Reset here (frame lifetime), rewound after every chunk (job lifetime)
+    while (meshArenas_.size() < jobs_->getThreadCount())
+        meshArenas_.push_back(std::make_unique<Arena>());
+    for (std::unique_ptr<Arena> &arena : meshArenas_)
+        arena->reset();
+
+    jobs_->parallelFor(chunkRebuilds_.size(), 1, [this](size_t begin, size_t end)
+                       {
+                           Arena &arena = *meshArenas_[jobs_->getCurrentThreadIndex()];
+                           for (size_t i = begin; i < end; ++i)
+                               rebuildChunkMesh(chunkRebuilds_[i], arena);
+                       });
+
+    for (const ChunkRebuild &rebuild : chunkRebuilds_)
+        ++chunkRebuildsPerLod_[rebuild.lod];
+    return true;
+}
+
+void Application::reportChunkRebuilds(std::ostream &out, const std::string &label)
+{
+    uint64_t total = 0;
+    for (uint64_t count : chunkRebuildsPerLod_)
+        total += count;
+    out << label << ": " << total << " chunk mesh(es), per LOD:";
+    for (uint64_t &count : chunkRebuildsPerLod_)
+    {
+        out << ' ' << count;
+        count = 0;
     }
+    out << std::endl;
+}
+
+void Application::rebuildChunkMesh(const ChunkRebuild &rebuild, Arena &arena)
+{
+    PROFILE_SCOPE("MeshChunk");
+
+    const glm::ivec3 &c = rebuild.coords;
+    const size_t chunkIndex = rebuild.chunkIndex;
+    ChunkMesh &chunk = chunkMeshes_[chunkIndex];
+    if (softwareRenderer_)
+    {
+        // The CPU rasterizer reads MeshData directly, nothing to upload. The mesh is built as a
+        // temporary in the thread's arena, so in steady state nothing here touches the heap.
+        ArenaScope scope(arena);
+        ArenaMeshData meshData(arena);
+        MeshBuilder::generateChunkMesh(gameWorld_, c.x, c.y, c.z, rebuild.lod, meshData, layer_mapping);
+        chunk.cpuMesh.assign(meshData);
+        return;
+    }
+
+    MeshBuilder::ChunkCells cells;
+    MeshBuilder::classifyChunk(gameWorld_, c.x, c.y, c.z, rebuild.lod, cells);
+
+    // The upload is handed to the main thread through the task queue, keyed by chunk, so a chunk
+    // re-meshed again before its upload ran only uploads the newest mesh. The old mesh keeps
+    // being drawn until then. Edits jump ahead of LOD changes.
+    const TaskPriority priority = rebuild.edited ? TaskPriority::HIGH : TaskPriority::LOW;
+    const uint64_t coalescingKey = chunkIndex + 1; // 0 means "no coalescing"
+
+    if (config_.vertexPulling)
+    {
+        // One 8-byte record per face; the vertex shader expands it into the corners
+        chunk.stagingQuads.resize(cells.quadCount());
+        MeshBuilder::emitChunkQuads(cells, chunk.stagingQuads.data(), layer_mapping);
+        mainThreadTasks_.submit(
+            [this, chunkIndex]()
+            {
+                ChunkMesh &target = chunkMeshes_[chunkIndex];
+                if (target.stagingQuads.empty())
+                {
+                    target.quadMesh.reset(); // Nothing to draw in this chunk
+                    return;
+                }
+                try
+                {
+                    PROFILE_SCOPE("UploadChunkMesh");
+                    target.quadMesh = std::make_unique<QuadMesh>(target.stagingQuads.data(), target.stagingQuads.size(), *quadIndices_);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "Mesh Creation Error: " << e.what() << std::endl;
+                    target.quadMesh.reset();
+                }
+            },
+            priority, coalescingKey);
+        return;
+    }
+
+    // Size the staging buffer from the cell counts, then let the mesher write the final
+    // vertex layout straight into it (no attribute arrays, no interleaving pass). No indices
+    // are written: the GL mesh draws with the shared quad index buffer.
+    chunk.stagingVertices.resize(cells.vertexCount());
+    PackedMeshWriter writer(chunk.stagingVertices.data());
+    MeshBuilder::emitChunkCells(cells, writer, layer_mapping);
+    assert(writer.writtenVertices == chunk.stagingVertices.size());
+
+    mainThreadTasks_.submit(
+        [this, chunkIndex]()
+        {
+            ChunkMesh &target = chunkMeshes_[chunkIndex];
+            if (target.stagingVertices.empty())
+            {
+                target.mesh.reset(); // Nothing to draw in this chunk
+                return;
+            }
+            try
+            {
+                PROFILE_SCOPE("UploadChunkMesh");
+                target.mesh = std::make_unique<Mesh>(reinterpret_cast<const float *>(target.stagingVertices.data()),
+                                                     target.stagingVertices.size() * sizeof(PackedVertex),
+                                                     *quadIndices_,
+                                                     target.stagingVertices.size() / 4,
+                                                     sizeof(PackedVertex),
+                                                     PackedVertex::attributeLayout,
+                                                     PackedVertex::integerAttributeLayout);
+                if (target.mesh->VAO == 0)
+                { // Check if VAO creation failed (though Mesh constructor doesn't explicitly return status)
+                    throw std::runtime_error("Mesh VAO creation failed (or Mesh constructor indicated error).");
+                }
+            }
+            catch (const std::exception &e)
+            { // Catch potential errors if Mesh throws
+                std::cerr << "Mesh Creation Error: " << e.what() << std::endl;
+                target.mesh.reset();
+            }
+        },
+        priority, coalescingKey);
+}
+
+void Application::setupScene()
+{
+
+    std::cout << "Setting up scene..." << std::endl;
+
+    gameWorld_.fillRegion(glm::ivec3(0, 0, 0), glm::ivec3(15, 0, 15), BlockType::DIRT);
 
     gameWorld_.addBlock(3, 1, 3, BlockType::WOOD_OAK);
     gameWorld_.addBlock(3, 2, 3, BlockType::WOOD_OAK);
@@ -507,13 +926,43 @@ void Application::setupScene()
 
     gameWorld_.addBlock(7, 1, 5, BlockType::STONE);
 
+    // A few dropped blocks falling onto the floor
+    const glm::vec3 droppedHalfExtents(0.125f);
+    entities_.create(EntityKind::DROPPED_ITEM, glm::vec3(9.5f, 4.0f, 9.5f), glm::vec3(0.0f), droppedHalfExtents, 1.0f, true, BlockType::COBBLESTONE);
+    entities_.create(EntityKind::DROPPED_ITEM, glm::vec3(10.5f, 5.0f, 9.5f), glm::vec3(1.0f, 0.0f, 0.0f), droppedHalfExtents, 1.0f, true, BlockType::SAND);
+    entities_.create(EntityKind::DROPPED_ITEM, glm::vec3(9.5f, 6.0f, 10.5f), glm::vec3(0.0f, 2.0f, 1.0f), droppedHalfExtents, 1.0f, true, BlockType::OAK_PLANK);
+
     std::cout
         << "Scene setup complete. "
         << std::endl;
 }
 
+bool Application::shouldClose() const
+{
+    return window_ ? window_->shouldClose() : false;
+}
+
+void Application::presentFrame()
+{
+    PROFILE_SCOPE("SwapBuffers");
+    if (headless_)
+    {
+        headless_->finishFrame();
+        return;
+    }
+    window_->swapBuffers();
+    window_->pollEvents();
+}
+
 void Application::processInput()
 {
+    PROFILE_SCOPE("ProcessInput");
+    if (headless_)
+    {
+        // Nothing to read without a window; a replay supplies the input instead
+        input_ = InputState();
+        return;
+    }
     GLFWwindow *w = window_->getGLFWwindow();
 
     if (glfwGetKey(w, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -522,6 +971,40 @@ void Application::processInput()
         return;
     }
 
+    // F2 writes the profiler's recorded zones to a Chrome trace file
+    bool traceKeyDown = (glfwGetKey(w, GLFW_KEY_F2) == GLFW_PRESS);
+    if (traceKeyDown && !traceKeyWasDown_)
+    {
+#ifdef ENABLE_PROFILER
+        Profiler::writeChromeTrace("trace.json");
+#else
+        std::cout << "Profiler is compiled out, rebuild with 'make PROFILE=1' to record traces." << std::endl;
+#endif
+    }
+    traceKeyWasDown_ = traceKeyDown;
+
+    // F3 cycles the debug views, F4 toggles fog. Both only pick another shader variant
+    // (compiled on first use), so they are not part of the recorded input.
+    bool debugViewKeyDown = (glfwGetKey(w, GLFW_KEY_F3) == GLFW_PRESS);
+    bool fogKeyDown = (glfwGetKey(w, GLFW_KEY_F4) == GLFW_PRESS);
+    if ((debugViewKeyDown && !debugViewKeyWasDown_) || (fogKeyDown && !fogKeyWasDown_))
+    {
+        const DebugView previousView = debugView_;
+        const bool previousFog = fogEnabled_;
+        if (debugViewKeyDown && !debugViewKeyWasDown_)
+            debugView_ = static_cast<DebugView>((static_cast<int>(debugView_) + 1) % static_cast<int>(DebugView::Count));
+        if (fogKeyDown && !fogKeyWasDown_)
+            fogEnabled_ = !fogEnabled_;
+        if (!selectShaderVariants())
+        {
+            std::cerr << "Shader variant failed to build, keeping the current one." << std::endl;
+            debugView_ = previousView;
+            fogEnabled_ = previousFog;
+        }
+    }
+    debugViewKeyWasDown_ = debugViewKeyDown;
+    fogKeyWasDown_ = fogKeyDown;
+
     // -- keyboard --
     input_.forward = (glfwGetKey(w, GLFW_KEY_W) == GLFW_PRESS);
     input_.backward = (glfwGetKey(w, GLFW_KEY_S) == GLFW_PRESS);
@@ -530,6 +1013,10 @@ void Application::processInput()
     input_.up = (glfwGetKey(w, GLFW_KEY_SPACE) == GLFW_PRESS);
     input_.down = (glfwGetKey(w, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS);
 
+    bool flyKeyDown = (glfwGetKey(w, GLFW_KEY_F) == GLFW_PRESS);
+    input_.toggleFly = flyKeyDown && !flyKeyWasDown_;
+    flyKeyWasDown_ = flyKeyDown;
+
     // -- mouse --
     double xpos, ypos;
     glfwGetCursorPos(w, &xpos, &ypos);
@@ -547,39 +1034,211 @@ void Application::processInput()
 
 void Application::update(float dt)
 {
+    PROFILE_SCOPE("UpdateTick");
     // --- keyboard move ---
     glm::vec3 forwardDir = glm::normalize(camera_.target - camera_.position);
+
+    // Walking moves on the horizontal plane only, flying follows the look direction
+    glm::vec3 moveForward = forwardDir;
+    if (!player_.flying)
+    {
+        moveForward.y = 0.0f;
+        if (glm::length(moveForward) > 0.0f)
+            moveForward = glm::normalize(moveForward);
+    }
     glm::vec3 rightDir = glm::normalize(glm::cross(forwardDir, camera_.up));
 
     glm::vec3 motion(0.0f);
     if (input_.forward)
-        motion += forwardDir;
+        motion += moveForward;
     if (input_.backward)
-        motion -= forwardDir;
+        motion -= moveForward;
     if (input_.right)
         motion += rightDir;
     if (input_.left)
         motion -= rightDir;
-    if (input_.up)
-        motion += camera_.up;
-    if (input_.down)
-        motion -= camera_.up;
+    if (player_.flying)
+    {
+        if (input_.up)
+            motion += camera_.up;
+        if (input_.down)
+            motion -= camera_.up;
+    }
 
     if (glm::length(motion) > 0.0f)
     {
-        motion = glm::normalize(motion) * cameraSpeed_ * dt;
-        camera_.position += motion;
-        camera_.target += motion;
+        motion = glm::normalize(motion);
     }
+
+    // Space jumps while walking
+    player_.update(gameWorld_, motion, input_.up, dt);
+
+    camera_.position = player_.getEyePosition();
+    camera_.target = camera_.position + forwardDir;
+
+    // Mobs, dropped items, projectiles
+    entities_.update(gameWorld_, dt);
 }
 
 void Application::render()
 {
+    PROFILE_SCOPE("Render");
+    if (softwareRenderer_)
+    {
+        renderSoftware();
+        return;
+    }
+
     // Renderer already handles clear, shader use, matrix setup, drawing
     if (renderer_)
+        renderer_->beginFrame(camera_, simulationTime_, fogColor_, fogRange_);
+    if (renderer_ && quadShader_)
+    {
+        quadDrawList_.clear();
+        for (const ChunkMesh &chunk : chunkMeshes_)
+        {
+            if (chunk.quadMesh)
+                quadDrawList_.push_back(chunk.quadMesh.get());
+        }
+
+        renderer_->renderQuads(*quadShader_, blockTextureArrayId, quadDrawList_);
+        renderEntities();
+    }
+    else if (renderer_)
+    {
+        chunkDrawList_.clear();
+        for (const ChunkMesh &chunk : chunkMeshes_)
+        {
+            if (chunk.mesh)
+                chunkDrawList_.push_back(chunk.mesh.get());
+        }
+
+        renderer_->render(blockTextureArrayId, chunkDrawList_);
+        renderEntities();
+    }
+}
+
+void Application::buildEntityInstances()
+{
+    const EntityComponents &c = entities_.components();
+    entityInstanceData_.clear();
+    entityInstanceData_.reserve(c.size());
+    for (size_t i = 0; i < c.size(); ++i)
+    {
+        InstanceData instance;
+        instance.model = glm::translate(glm::mat4(1.0f), glm::vec3(c.posX[i], c.posY[i], c.posZ[i]));
+        // Non-uniform scale, no rotation: instanced.vs relies on this to transform normals
+        // with the model matrix itself
+        instance.model = glm::scale(instance.model, glm::vec3(c.halfX[i], c.halfY[i], c.halfZ[i]) * 2.0f);
+
+        auto mapping = layer_mapping.find(c.blockType[i]);
+        instance.layer = (mapping != layer_mapping.end()) ? static_cast<float>(mapping->second.front) : -1.0f;
+
+        entityInstanceData_.push_back(instance);
+    }
+}
+
+void Application::renderEntities()
+{
+    buildEntityInstances();
     {
-        renderer_->render(gameWorld_, camera_, blockTextureArrayId);
+        PROFILE_SCOPE("UploadEntityInstances");
+        entityInstances_->upload(entityInstanceData_);
     }
+    renderer_->renderInstanced(*entityMesh_, *entityInstances_, *entityShader_, blockTextureArrayId);
+}
+
+void Application::renderSoftware()
+{
+    softwareDrawList_.clear();
+    for (const ChunkMesh &chunk : chunkMeshes_)
+    {
+        if (!chunk.cpuMesh.indices.empty())
+            softwareDrawList_.push_back(&chunk.cpuMesh);
+    }
+    buildEntityInstances();
+
+    {
+        PROFILE_SCOPE("SoftwareRasterize");
+        softwareRenderer_->beginFrame(framebufferWidth_, framebufferHeight_, camera_);
+        softwareRenderer_->drawMeshes(softwareDrawList_);
+        softwareRenderer_->drawInstances(entityMeshData_, entityInstanceData_);
+        softwareRenderer_->endFrame();
+    }
+
+    // Upload the image and copy it onto whatever framebuffer is bound for drawing
+    PROFILE_SCOPE("PresentSoftwareFrame");
+    int width = softwareRenderer_->getWidth();
+    int height = softwareRenderer_->getHeight();
+    GLState::bindTexture(0, GL_TEXTURE_2D, softwareFrameTexture_);
+    GLint textureWidth = 0, textureHeight = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &textureWidth);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &textureHeight);
+    if (textureWidth != width || textureHeight != height)
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, softwareRenderer_->getColorBuffer().data());
+    else
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, softwareRenderer_->getColorBuffer().data());
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, softwareFrameFbo_);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    if (headless_)
+        headless_->bindFramebuffer();
+    else
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+bool Application::initSoftwareRenderer()
+{
+    // The rasterizer samples a CPU copy of the block texture array, read back level by level
+    // so it holds exactly what the GL path samples (including the generated mipmaps)
+    SoftwareTexture texture;
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, blockTextureArrayId);
+    for (int level = 0;; ++level)
+    {
+        GLint width = 0, height = 0, layers = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, level, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, level, GL_TEXTURE_HEIGHT, &height);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, level, GL_TEXTURE_DEPTH, &layers);
+        if (width == 0 || height == 0)
+            break;
+
+        SoftwareTexture::Level mip;
+        mip.width = width;
+        mip.height = height;
+        mip.texels.resize(static_cast<size_t>(width) * height * layers);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTexImage(GL_TEXTURE_2D_ARRAY, level, GL_RGBA, GL_UNSIGNED_BYTE, mip.texels.data());
+        texture.layers = layers;
+        texture.levels.push_back(std::move(mip));
+
+        if (width == 1 && height == 1)
+            break;
+    }
+    if (texture.levels.empty())
+    {
+        std::cerr << "Software renderer: could not read back the block textures." << std::endl;
+        return false;
+    }
+
+    softwareRenderer_ = std::make_unique<SoftwareRenderer>(*jobs_);
+    softwareRenderer_->setTexture(std::move(texture));
+
+    // Target for presenting the CPU image: a texture attached to a read framebuffer
+    glGenTextures(1, &softwareFrameTexture_);
+    GLState::bindTexture(0, GL_TEXTURE_2D, softwareFrameTexture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, framebufferWidth_, framebufferHeight_, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glGenFramebuffers(1, &softwareFrameFbo_);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, softwareFrameFbo_);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, softwareFrameTexture_, 0);
+    if (headless_)
+        headless_->bindFramebuffer();
+    else
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    std::cout << "Software renderer created (" << softwareRenderer_->getThreadCount() << " threads)." << std::endl;
+    return true;
 }
 
 void Application::shutdown()
@@ -588,10 +1247,35 @@ void Application::shutdown()
     // Cleanup is largely handled by unique_ptr destructors calling the
     // destructors of Window, Shader, Mesh, Renderer in the correct order.
     // Explicit cleanup can be done here if needed (e.g., detaching shaders before deleting program if not done in Shader destructor)
+    if (inputRecorder_)
+    {
+        std::cout << "Recorded " << inputRecorder_->frameCount() << " frames of input to " << config_.recordInputPath << std::endl;
+        inputRecorder_.reset();
+    }
+    inputPlayback_.reset();
+    mainThreadTasks_.clear(); // Queued uploads refer to chunk meshes and the GL context
+    shaderWatcher_.reset();
     renderer_.reset();
-    worldMesh_.reset();
-    blockShader_.reset();
+    softwareRenderer_.reset();
+    jobs_.reset(); // After everything that runs jobs
+    if (softwareFrameFbo_)
+    {
+        glDeleteFramebuffers(1, &softwareFrameFbo_);
+        glDeleteTextures(1, &softwareFrameTexture_);
+        GLState::textureDeleted(softwareFrameTexture_);
+    }
+    gpuFrameTimer_.reset();
+    entityInstances_.reset();
+    entityMesh_.reset();
+    chunkMeshes_.clear();
+    quadIndices_.reset(); // After the meshes drawing with it
+    blockShader_ = nullptr;
+    quadShader_ = nullptr;
+    entityShader_ = nullptr;
+    shaderVariants_.clear();
     glDeleteTextures(1, &blockTextureArrayId);
+    GLState::textureDeleted(blockTextureArrayId);
     window_.reset(); // This triggers Window destructor, cleaning up GLFW
+    headless_.reset();
     std::cout << "Application shutdown complete." << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <cassert>
+
+Arena::Arena(size_t blockSize)
+    : blockSize_(blockSize)
+{
+}
+
+Arena::~Arena() = default;
+
+void Arena::addBlock(size_t minimumSize)
+{
+    Block block;
+    block.size = std::max(blockSize_, minimumSize);
+    block.data.reset(new unsigned char[block.size]);
+    blocks_.push_back(std::move(block));
+    blockAllocations_++;
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+    if (size == 0)
+        size = 1;
+
+    // Current block first, then any later block kept from earlier use, then a new one
+    for (;;)
+    {
+        if (current_ < blocks_.size())
+        {
+            Block &block = blocks_[current_];
+            uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+            uintptr_t aligned = (base + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            size_t start = static_cast<size_t>(aligned - base);
+            if (start + size <= block.size)
+            {
+                offset_ = start + size;
+                peakBytes_ = std::max(peakBytes_, bytesUsed());
+                return block.data.get() + start;
+            }
+            if (current_ + 1 < blocks_.size())
+            {
+                ++current_;
+                offset_ = 0;
+                continue;
+            }
+        }
+
+        addBlock(size + alignment);
+        current_ = blocks_.size() - 1;
+        offset_ = 0;
+    }
+}
+
+void Arena::deallocate(void *pointer, size_t size)
+{
+    if (current_ >= blocks_.size())
+        return;
+    unsigned char *bytes = static_cast<unsigned char *>(pointer);
+    unsigned char *top = blocks_[current_].data.get() + offset_;
+    if (bytes + size == top)
+        offset_ -= size;
+}
+
+void Arena::rewind(const Marker &marker)
+{
+    assert(marker.block < current_ || (marker.block == current_ && marker.offset <= offset_));
+    current_ = marker.block;
+    offset_ = marker.offset;
+}
+
+void Arena::reset()
+{
+    // Several blocks mean the arena outgrew its first block; swap them for one block the size
+    // of the high-water mark so the next frames fit without spilling again
+    if (blocks_.size() > 1)
+    {
+        size_t total = std::max(capacity(), peakBytes_);
+        blocks_.clear();
+        addBlock(total);
+    }
+    current_ = 0;
+    offset_ = 0;
+}
+
+size_t Arena::bytesUsed() const
+{
+    size_t used = offset_;
+    for (size_t i = 0; i < current_ && i < blocks_.size(); ++i)
+        used += blocks_[i].size;
+    return used;
+}
+
+size_t Arena::capacity() const
+{
+    size_t total = 0;
+    for (const Block &block : blocks_)
+        total += block.size;
+    return total;
+}
@@ -0,0 +1,313 @@
+#include "EntityManager.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr uint32_t kSlotBits = 24;
+    constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+    constexpr uint32_t kNoDenseIndex = 0xFFFFFFFFu;
+    // A slot whose generation reaches this is retired instead of reused: wrapping to 0 would
+    // make stale handles valid again, and slot kSlotMask at this generation is INVALID_ENTITY
+    constexpr uint8_t kRetiredGeneration = 0xFF;
+    // Entities falling below this height have left the world and are destroyed
+    constexpr float kKillPlaneY = -64.0f;
+    // Below this squared speed a resting entity is considered stopped
+    constexpr float kRestSpeedSq = 1e-6f;
+    // Inset of the footprint corners, so a box flush with a block face does not count as over it
+    constexpr float kSkin = 1e-3f;
+
+    uint32_t slotOf(Entity entity) { return entity & kSlotMask; }
+    uint8_t generationOf(Entity entity) { return static_cast<uint8_t>(entity >> kSlotBits); }
+    Entity makeEntity(uint32_t slot, uint8_t generation) { return (static_cast<uint32_t>(generation) << kSlotBits) | slot; }
+
+    // floor() to int without the libm call std::floor compiles to on baseline x86-64
+    int fastFloor(float value)
+    {
+        int truncated = static_cast<int>(value);
+        return truncated - (value < static_cast<float>(truncated));
+    }
+
+    // --- Systems ---
+    // Each system is a flat loop over raw arrays with no aliasing and no branches,
+    // so the compiler can vectorize it.
+
+    void applyGravity(float *__restrict velY, const float *__restrict gravityScale, size_t count, float gravityStep)
+    {
+        for (size_t i = 0; i < count; ++i)
+            velY[i] -= gravityScale[i] * gravityStep;
+    }
+
+    void integrate(float *__restrict pos, const float *__restrict vel, size_t count, float dt)
+    {
+        for (size_t i = 0; i < count; ++i)
+            pos[i] += vel[i] * dt;
+    }
+
+    // Collects the dense indices of colliding entities that move horizontally; only they can
+    // run into a wall, and most entities (dropped items at rest) do not move. The index is
+    // written every time and the count advanced by 0 or 1, so there is no branch.
+    size_t collectMoving(const float *__restrict velX, const float *__restrict velZ, const uint8_t *__restrict collides,
+                         uint32_t *__restrict indices, size_t count)
+    {
+        size_t moving = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            indices[moving] = static_cast<uint32_t>(i);
+            moving += static_cast<size_t>(((velX[i] != 0.0f) | (velZ[i] != 0.0f)) & collides[i]);
+        }
+        return moving;
+    }
+
+    // Cell just past the leading face (the face it moves towards) of each listed entity along
+    // one horizontal axis, at the height and other-axis position of its center
+    void computeLeadCells(const uint32_t *__restrict indices, const float *__restrict pos, const float *__restrict vel, const float *__restrict half,
+                          const float *__restrict posY, const float *__restrict posOther,
+                          int *__restrict cellAxis, int *__restrict cellY, int *__restrict cellOther, size_t count)
+    {
+        for (size_t k = 0; k < count; ++k)
+        {
+            const uint32_t i = indices[k];
+            float lead = pos[i] + (vel[i] < 0.0f ? -half[i] : half[i]);
+            cellAxis[k] = fastFloor(lead);
+            cellY[k] = fastFloor(posY[i]);
+            cellOther[k] = fastFloor(posOther[i]);
+        }
+    }
+
+    // Puts listed entities whose leading face moved into a solid cell back against that
+    // cell's face and stops them along the axis. Selects instead of branches, like resolveGround.
+    void resolveSide(const uint32_t *__restrict indices, float *__restrict pos, float *__restrict vel, const float *__restrict half,
+                     const int *__restrict cellAxis, const uint8_t *__restrict solid, size_t count)
+    {
+        for (size_t k = 0; k < count; ++k)
+        {
+            const uint32_t i = indices[k];
+            float hit = static_cast<float>(solid[k]);
+            float face = vel[i] < 0.0f ? static_cast<float>(cellAxis[k] + 1) + half[i] : static_cast<float>(cellAxis[k]) - half[i];
+            pos[i] += hit * (face - pos[i]);
+            vel[i] -= hit * vel[i];
+        }
+    }
+
+    // Range of cells under each entity's footprint (at most 2x2 for boxes up to a block
+    // wide), at the height of its feet
+    void computeFootprintCells(const float *__restrict posX, const float *__restrict posY, const float *__restrict posZ,
+                               const float *__restrict halfX, const float *__restrict halfY, const float *__restrict halfZ,
+                               int *__restrict cellX0, int *__restrict cellX1, int *__restrict cellY,
+                               int *__restrict cellZ0, int *__restrict cellZ1, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            cellX0[i] = fastFloor(posX[i] - halfX[i] + kSkin);
+            cellX1[i] = fastFloor(posX[i] + halfX[i] - kSkin);
+            cellY[i] = fastFloor(posY[i] - halfY[i]);
+            cellZ0[i] = fastFloor(posZ[i] - halfZ[i] + kSkin);
+            cellZ1[i] = fastFloor(posZ[i] + halfZ[i] - kSkin);
+        }
+    }
+
+    // Rests falling entities on top of the voxels under their footprint. Written with selects
+    // instead of branches: which entities land is effectively random, and mispredicted
+    // branches would otherwise dominate the tick.
+    void resolveGround(float *__restrict posY, float *__restrict velX, float *__restrict velY, float *__restrict velZ,
+                       const float *__restrict halfY, const uint8_t *__restrict collides,
+                       const int *__restrict cellY, const uint8_t *__restrict solid, size_t count, float frictionFactor)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Blend factor: 1 if the entity lands this tick, 0 otherwise
+            int lands = (solid[i] & collides[i]) & (velY[i] <= 0.0f);
+            float hit = static_cast<float>(lands);
+            float restY = static_cast<float>(cellY[i] + 1) + halfY[i];
+            float friction = 1.0f + hit * (frictionFactor - 1.0f);
+            posY[i] += hit * (restY - posY[i]);
+            velY[i] -= hit * velY[i];
+            // Snap crawling speeds to zero; repeated decay would otherwise end in denormals,
+            // which are many times slower to operate on
+            float vx = velX[i] * friction;
+            float vz = velZ[i] * friction;
+            velX[i] = (vx * vx < kRestSpeedSq) ? 0.0f : vx;
+            velZ[i] = (vz * vz < kRestSpeedSq) ? 0.0f : vz;
+        }
+    }
+}
+
+Entity EntityManager::create(EntityKind kind, const glm::vec3 &position, const glm::vec3 &velocity, const glm::vec3 &halfExtents, float gravityScale, bool collides, BlockType blockType)
+{
+    uint32_t slot;
+    if (!freeSlots_.empty())
+    {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(sparse_.size());
+        if (slot > kSlotMask)
+            return INVALID_ENTITY; // Out of slots
+        sparse_.push_back(kNoDenseIndex);
+        generations_.push_back(0);
+    }
+
+    Entity entity = makeEntity(slot, generations_[slot]);
+    sparse_[slot] = static_cast<uint32_t>(components_.size());
+
+    components_.posX.push_back(position.x);
+    components_.posY.push_back(position.y);
+    components_.posZ.push_back(position.z);
+    components_.velX.push_back(velocity.x);
+    components_.velY.push_back(velocity.y);
+    components_.velZ.push_back(velocity.z);
+    components_.halfX.push_back(halfExtents.x);
+    components_.halfY.push_back(halfExtents.y);
+    components_.halfZ.push_back(halfExtents.z);
+    components_.gravityScale.push_back(gravityScale);
+    components_.collides.push_back(collides ? 1 : 0);
+    components_.kind.push_back(kind);
+    components_.blockType.push_back(blockType);
+    components_.owner.push_back(entity);
+
+    return entity;
+}
+
+void EntityManager::destroy(Entity entity)
+{
+    long index = denseIndex(entity);
+    if (index < 0)
+        return;
+
+    // Move the last element into the hole so the arrays stay packed
+    size_t dst = static_cast<size_t>(index);
+    size_t last = components_.size() - 1;
+    EntityComponents &c = components_;
+    if (dst != last)
+    {
+        c.posX[dst] = c.posX[last];
+        c.posY[dst] = c.posY[last];
+        c.posZ[dst] = c.posZ[last];
+        c.velX[dst] = c.velX[last];
+        c.velY[dst] = c.velY[last];
+        c.velZ[dst] = c.velZ[last];
+        c.halfX[dst] = c.halfX[last];
+        c.halfY[dst] = c.halfY[last];
+        c.halfZ[dst] = c.halfZ[last];
+        c.gravityScale[dst] = c.gravityScale[last];
+        c.collides[dst] = c.collides[last];
+        c.kind[dst] = c.kind[last];
+        c.blockType[dst] = c.blockType[last];
+        c.owner[dst] = c.owner[last];
+        sparse_[slotOf(c.owner[dst])] = static_cast<uint32_t>(dst);
+    }
+
+    c.posX.pop_back();
+    c.posY.pop_back();
+    c.posZ.pop_back();
+    c.velX.pop_back();
+    c.velY.pop_back();
+    c.velZ.pop_back();
+    c.halfX.pop_back();
+    c.halfY.pop_back();
+    c.halfZ.pop_back();
+    c.gravityScale.pop_back();
+    c.collides.pop_back();
+    c.kind.pop_back();
+    c.blockType.pop_back();
+    c.owner.pop_back();
+
+    uint32_t slot = slotOf(entity);
+    sparse_[slot] = kNoDenseIndex;
+    // Invalidate outstanding handles
+    if (++generations_[slot] != kRetiredGeneration)
+        freeSlots_.push_back(slot);
+}
+
+bool EntityManager::isAlive(Entity entity) const
+{
+    return denseIndex(entity) >= 0;
+}
+
+void EntityManager::clear()
+{
+    components_ = EntityComponents();
+    sparse_.clear();
+    generations_.clear();
+    freeSlots_.clear();
+}
+
+glm::vec3 EntityManager::getPosition(Entity entity) const
+{
+    long index = denseIndex(entity);
+    if (index < 0)
+        return glm::vec3(0.0f);
+    return glm::vec3(components_.posX[index], components_.posY[index], components_.posZ[index]);
+}
+
+void EntityManager::setVelocity(Entity entity, const glm::vec3 &velocity)
+{
+    long index = denseIndex(entity);
+    if (index < 0)
+        return;
+    components_.velX[index] = velocity.x;
+    components_.velY[index] = velocity.y;
+    components_.velZ[index] = velocity.z;
+}
+
+void EntityManager::update(const World &world, float dt)
+{
+    EntityComponents &c = components_;
+    size_t count = c.size();
+    if (count == 0)
+        return;
+
+    // Collision works one axis at a time: move horizontally and stop at walls while the
+    // height is still the resolved one from the last tick, then fall and land. Each step
+    // gathers its cells, queries the world for all of them at once and applies the result.
+    // Scratch arrays are reused across ticks.
+    cellX_.resize(count);
+    cellY_.resize(count);
+    cellZ_.resize(count);
+    cellX1_.resize(count);
+    cellZ1_.resize(count);
+    solid_.resize(count);
+
+    applyGravity(c.velY.data(), c.gravityScale.data(), count, gravity * dt);
+    movingIndices_.resize(count);
+    const size_t moving = collectMoving(c.velX.data(), c.velZ.data(), c.collides.data(), movingIndices_.data(), count);
+    const uint32_t *movers = movingIndices_.data();
+
+    integrate(c.posX.data(), c.velX.data(), count, dt);
+    computeLeadCells(movers, c.posX.data(), c.velX.data(), c.halfX.data(), c.posY.data(), c.posZ.data(), cellX_.data(), cellY_.data(), cellZ_.data(), moving);
+    world.isSolidBatch(cellX_.data(), cellY_.data(), cellZ_.data(), solid_.data(), moving);
+    resolveSide(movers, c.posX.data(), c.velX.data(), c.halfX.data(), cellX_.data(), solid_.data(), moving);
+
+    integrate(c.posZ.data(), c.velZ.data(), count, dt);
+    computeLeadCells(movers, c.posZ.data(), c.velZ.data(), c.halfZ.data(), c.posY.data(), c.posX.data(), cellZ_.data(), cellY_.data(), cellX_.data(), moving);
+    world.isSolidBatch(cellX_.data(), cellY_.data(), cellZ_.data(), solid_.data(), moving);
+    resolveSide(movers, c.posZ.data(), c.velZ.data(), c.halfZ.data(), cellZ_.data(), solid_.data(), moving);
+
+    integrate(c.posY.data(), c.velY.data(), count, dt);
+    computeFootprintCells(c.posX.data(), c.posY.data(), c.posZ.data(), c.halfX.data(), c.halfY.data(), c.halfZ.data(),
+                          cellX_.data(), cellX1_.data(), cellY_.data(), cellZ_.data(), cellZ1_.data(), count);
+    world.anySolidBatch(cellX_.data(), cellX1_.data(), cellY_.data(), cellZ_.data(), cellZ1_.data(), solid_.data(), count);
+    resolveGround(c.posY.data(), c.velX.data(), c.velY.data(), c.velZ.data(), c.halfY.data(), c.collides.data(),
+                  cellY_.data(), solid_.data(), count, std::max(0.0f, 1.0f - groundFriction * dt));
+
+    // Remove anything that fell out of the world. Walk backwards so swap-removal
+    // only ever moves elements that were already visited.
+    for (size_t i = count; i-- > 0;)
+    {
+        if (c.posY[i] < kKillPlaneY)
+            destroy(c.owner[i]);
+    }
+}
+
+long EntityManager::denseIndex(Entity entity) const
+{
+    if (entity == INVALID_ENTITY)
+        return -1;
+    uint32_t slot = slotOf(entity);
+    if (slot >= sparse_.size() || generations_[slot] != generationOf(entity) || sparse_[slot] == kNoDenseIndex)
+        return -1;
+    return static_cast<long>(sparse_[slot]);
+}
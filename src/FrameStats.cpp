@@ -0,0 +1,298 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    // Values below this are recorded exactly (one bucket per microsecond)
+    constexpr uint64_t kExactLimit = 64;
+    // Linear buckets per power-of-two range above the exact limit
+    constexpr int kSubBuckets = 32;
+    // Largest power of two tracked (2^32 us is over an hour); longer values are clamped
+    constexpr int kMaxMagnitude = 32;
+    constexpr size_t kBucketCount = kExactLimit + (kMaxMagnitude - 5) * kSubBuckets;
+
+    const char *kStageNames[static_cast<int>(FrameStage::Count)] = {"input", "update", "meshing", "render", "swap"};
+    const char *kGpuPassNames[static_cast<int>(GpuPass::Count)] = {"clear", "world", "entities"};
+
+    int highestBit(uint64_t value)
+    {
+        int bit = 0;
+        while (value >>= 1)
+            ++bit;
+        return bit;
+    }
+
+    size_t bucketIndex(uint64_t value)
+    {
+        if (value < kExactLimit)
+            return static_cast<size_t>(value);
+        value = std::min<uint64_t>(value, (uint64_t(1) << kMaxMagnitude) - 1);
+        int shift = highestBit(value) - 5; // keep the top 6 bits: 32..63
+        return kExactLimit + static_cast<size_t>(shift - 1) * kSubBuckets + static_cast<size_t>((value >> shift) - kSubBuckets);
+    }
+
+    // Midpoint of the range of values that land in a bucket
+    uint64_t bucketValue(size_t index)
+    {
+        if (index < kExactLimit)
+            return index;
+        size_t offset = index - kExactLimit;
+        int shift = static_cast<int>(offset / kSubBuckets) + 1;
+        uint64_t sub = offset % kSubBuckets + kSubBuckets;
+        uint64_t low = sub << shift;
+        uint64_t high = ((sub + 1) << shift) - 1;
+        return (low + high) / 2;
+    }
+
+    uint64_t toMicroseconds(double milliseconds)
+    {
+        return static_cast<uint64_t>(std::max(0.0, milliseconds) * 1000.0 + 0.5);
+    }
+
+    double toMilliseconds(uint64_t microseconds)
+    {
+        return static_cast<double>(microseconds) / 1000.0;
+    }
+}
+
+// --- LatencyHistogram ---
+
+LatencyHistogram::LatencyHistogram() : buckets_(kBucketCount, 0) {}
+
+void LatencyHistogram::record(uint64_t microseconds)
+{
+    buckets_[bucketIndex(microseconds)]++;
+    count_++;
+    max_ = std::max(max_, microseconds);
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    max_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const
+{
+    if (count_ == 0)
+        return 0;
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(count_)));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i)
+    {
+        seen += buckets_[i];
+        if (seen >= target)
+            return std::min(bucketValue(i), max_); // never report more than was actually seen
+    }
+    return max_;
+}
+
+// --- FrameStats ---
+
+FrameStats::FrameStats() : hitchCounts_(hitchThresholdsMs_.size(), 0) {}
+
+void FrameStats::setHitchThresholds(const std::vector<double> &thresholdsMs)
+{
+    hitchThresholdsMs_ = thresholdsMs;
+    hitchCounts_.assign(hitchThresholdsMs_.size(), 0);
+}
+
+void FrameStats::recordFrame(const FrameTiming &timing)
+{
+    cpuFrame_.record(toMicroseconds(timing.cpuFrameMs));
+    if (timing.gpuFrameMs >= 0.0)
+        gpuFrame_.record(toMicroseconds(timing.gpuFrameMs));
+    for (int stage = 0; stage < static_cast<int>(FrameStage::Count); ++stage)
+        stages_[stage].record(toMicroseconds(timing.stageMs[stage]));
+    for (int pass = 0; pass < static_cast<int>(GpuPass::Count); ++pass)
+    {
+        if (timing.gpuPassMs[pass] >= 0.0)
+            gpuPasses_[pass].record(toMicroseconds(timing.gpuPassMs[pass]));
+    }
+
+    for (size_t i = 0; i < hitchThresholdsMs_.size(); ++i)
+    {
+        if (timing.cpuFrameMs > hitchThresholdsMs_[i])
+            hitchCounts_[i]++;
+    }
+}
+
+bool FrameStats::openSink(const std::string &path)
+{
+    sink_.open(path, std::ios::out | std::ios::trunc);
+    if (!sink_)
+    {
+        std::cerr << "FrameStats: cannot open " << path << " for writing" << std::endl;
+        return false;
+    }
+    sinkIsJson_ = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    sinkHeaderWritten_ = false;
+    return true;
+}
+
+void FrameStats::report(std::ostream &out, double intervalSeconds)
+{
+    elapsedSeconds_ += intervalSeconds;
+    uint64_t frames = cpuFrame_.count();
+    if (frames == 0)
+        return;
+
+    auto printPercentiles = [&out](const LatencyHistogram &histogram)
+    {
+        out << "p50 " << toMilliseconds(histogram.percentile(50.0)) << "ms"
+            << "  p95 " << toMilliseconds(histogram.percentile(95.0)) << "ms"
+            << "  p99 " << toMilliseconds(histogram.percentile(99.0)) << "ms"
+            << "  max " << toMilliseconds(histogram.max()) << "ms";
+    };
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    out << "Frame time over " << intervalSeconds << "s (" << frames << " frames, "
+        << static_cast<double>(frames) / intervalSeconds << " FPS): ";
+    printPercentiles(cpuFrame_);
+    out << "\n  Hitches:";
+    for (size_t i = 0; i < hitchThresholdsMs_.size(); ++i)
+        out << "  >" << hitchThresholdsMs_[i] << "ms: " << hitchCounts_[i];
+    if (gpuFrame_.count() > 0)
+    {
+        out << "\n  GPU: ";
+        printPercentiles(gpuFrame_);
+    }
+    if (hasGpuPasses())
+    {
+        out << "\n  GPU passes (p50/p99 ms):";
+        for (int pass = 0; pass < static_cast<int>(GpuPass::Count); ++pass)
+        {
+            out << "  " << kGpuPassNames[pass] << " " << toMilliseconds(gpuPasses_[pass].percentile(50.0))
+                << "/" << toMilliseconds(gpuPasses_[pass].percentile(99.0));
+        }
+    }
+    out << "\n  Stages (p50/p99 ms):";
+    for (int stage = 0; stage < static_cast<int>(FrameStage::Count); ++stage)
+    {
+        out << "  " << kStageNames[stage] << " " << toMilliseconds(stages_[stage].percentile(50.0))
+            << "/" << toMilliseconds(stages_[stage].percentile(99.0));
+    }
+    out << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+
+    if (sink_.is_open())
+    {
+        if (sinkIsJson_)
+            writeJsonLine(intervalSeconds);
+        else
+            writeCsvRow(intervalSeconds);
+        sink_.flush();
+    }
+}
+
+void FrameStats::reset()
+{
+    cpuFrame_.reset();
+    gpuFrame_.reset();
+    for (LatencyHistogram &stage : stages_)
+        stage.reset();
+    for (LatencyHistogram &pass : gpuPasses_)
+        pass.reset();
+    std::fill(hitchCounts_.begin(), hitchCounts_.end(), 0);
+}
+
+void FrameStats::writeCsvRow(double intervalSeconds)
+{
+    auto writePercentileColumns = [this](const LatencyHistogram &histogram)
+    {
+        sink_ << ',' << toMilliseconds(histogram.percentile(50.0))
+              << ',' << toMilliseconds(histogram.percentile(95.0))
+              << ',' << toMilliseconds(histogram.percentile(99.0))
+              << ',' << toMilliseconds(histogram.max());
+    };
+
+    if (!sinkHeaderWritten_)
+    {
+        sink_ << "time_s,interval_s,frames";
+        for (const char *prefix : {"cpu", "gpu"})
+            sink_ << ',' << prefix << "_p50_ms," << prefix << "_p95_ms," << prefix << "_p99_ms," << prefix << "_max_ms";
+        for (double threshold : hitchThresholdsMs_)
+            sink_ << ",hitches_over_" << threshold << "ms";
+        for (const char *stage : kStageNames)
+            sink_ << ',' << stage << "_p50_ms," << stage << "_p95_ms," << stage << "_p99_ms," << stage << "_max_ms";
+        for (const char *pass : kGpuPassNames)
+            sink_ << ",gpu_" << pass << "_p50_ms,gpu_" << pass << "_p95_ms,gpu_" << pass << "_p99_ms,gpu_" << pass << "_max_ms";
+        sink_ << '\n';
+        sinkHeaderWritten_ = true;
+    }
+
+    sink_ << elapsedSeconds_ << ',' << intervalSeconds << ',' << cpuFrame_.count();
+    writePercentileColumns(cpuFrame_);
+    writePercentileColumns(gpuFrame_);
+    for (uint64_t hitches : hitchCounts_)
+        sink_ << ',' << hitches;
+    for (const LatencyHistogram &stage : stages_)
+        writePercentileColumns(stage);
+    for (const LatencyHistogram &pass : gpuPasses_)
+        writePercentileColumns(pass);
+    sink_ << '\n';
+}
+
+void FrameStats::writeJsonLine(double intervalSeconds)
+{
+    auto writePercentileObject = [this](const LatencyHistogram &histogram)
+    {
+        sink_ << "{\"p50_ms\":" << toMilliseconds(histogram.percentile(50.0))
+              << ",\"p95_ms\":" << toMilliseconds(histogram.percentile(95.0))
+              << ",\"p99_ms\":" << toMilliseconds(histogram.percentile(99.0))
+              << ",\"max_ms\":" << toMilliseconds(histogram.max()) << '}';
+    };
+
+    sink_ << "{\"time_s\":" << elapsedSeconds_ << ",\"interval_s\":" << intervalSeconds << ",\"frames\":" << cpuFrame_.count();
+    sink_ << ",\"cpu\":";
+    writePercentileObject(cpuFrame_);
+    if (gpuFrame_.count() > 0)
+    {
+        sink_ << ",\"gpu\":";
+        writePercentileObject(gpuFrame_);
+    }
+    sink_ << ",\"hitches\":{";
+    for (size_t i = 0; i < hitchThresholdsMs_.size(); ++i)
+        sink_ << (i ? "," : "") << "\"over_" << hitchThresholdsMs_[i] << "ms\":" << hitchCounts_[i];
+    sink_ << "},\"stages\":{";
+    for (int stage = 0; stage < static_cast<int>(FrameStage::Count); ++stage)
+    {
+        sink_ << (stage ? "," : "") << '"' << kStageNames[stage] << "\":";
+        writePercentileObject(stages_[stage]);
+    }
+    sink_ << '}';
+    if (hasGpuPasses())
+    {
+        sink_ << ",\"gpu_passes\":{";
+        for (int pass = 0; pass < static_cast<int>(GpuPass::Count); ++pass)
+        {
+            sink_ << (pass ? "," : "") << '"' << kGpuPassNames[pass] << "\":";
+            writePercentileObject(gpuPasses_[pass]);
+        }
+        sink_ << '}';
+    }
+    sink_ << "}\n";
+}
+
+bool FrameStats::hasGpuPasses() const
+{
+    for (const LatencyHistogram &pass : gpuPasses_)
+    {
+        if (pass.count() > 0)
+            return true;
+    }
+    return false;
+}
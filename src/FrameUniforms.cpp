@@ -0,0 +1,35 @@
+#include "FrameUniforms.h"
+#include "GLPlatform.h"
+#include "GLState.h"
+
+#include <cstring>
+
+FrameUniforms::FrameUniforms()
+{
+    glGenBuffers(1, &UBO_);
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, UBO_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), NULL, GL_STREAM_DRAW);
+    GLState::bindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, UBO_);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    glDeleteBuffers(1, &UBO_);
+    GLState::bufferDeleted(UBO_);
+}
+
+void FrameUniforms::update(const FrameUniformData &data)
+{
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, UBO_);
+    // Invalidating the whole buffer lets the driver hand out fresh storage (orphaning)
+    void *mapped = glMapBufferRange(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped)
+    {
+        std::memcpy(mapped, &data, sizeof(FrameUniformData));
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    }
+    else
+    {
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), &data, GL_STREAM_DRAW);
+    }
+}
@@ -0,0 +1,280 @@
+#include "GLState.h"
+#include "GLPlatform.h"
+
+#include <iomanip>
+
+namespace
+{
+    constexpr unsigned int kTextureUnits = 16; // Units tracked; GL 3.3 guarantees at least 16
+    constexpr unsigned int kUnknown = ~0u;     // Value no GL name has: forces the next call through
+
+    enum TextureTarget
+    {
+        TEXTURE_2D = 0,
+        TEXTURE_2D_ARRAY,
+        TEXTURE_BUFFER_TARGET,
+        TEXTURE_TARGET_COUNT
+    };
+
+    enum BufferTarget
+    {
+        ARRAY_BUFFER = 0,
+        TEXTURE_BUFFER_BINDING,
+        UNIFORM_BUFFER,
+        BUFFER_TARGET_COUNT
+    };
+
+    enum Capability
+    {
+        DEPTH_TEST = 0,
+        CULL_FACE,
+        BLEND,
+        CAPABILITY_COUNT
+    };
+
+    struct State
+    {
+        unsigned int program = kUnknown;
+        unsigned int vertexArray = kUnknown;
+        unsigned int activeUnit = kUnknown;
+        unsigned int textures[kTextureUnits][TEXTURE_TARGET_COUNT];
+        unsigned int buffers[BUFFER_TARGET_COUNT];
+        int capabilities[CAPABILITY_COUNT]; // 0/1, or -1 when unknown
+        float clearColor[4];
+        bool clearColorKnown = false;
+
+        State() { forget(); }
+
+        void forget()
+        {
+            program = kUnknown;
+            vertexArray = kUnknown;
+            activeUnit = kUnknown;
+            for (auto &unit : textures)
+                for (unsigned int &texture : unit)
+                    texture = kUnknown;
+            for (unsigned int &buffer : buffers)
+                buffer = kUnknown;
+            for (int &capability : capabilities)
+                capability = -1;
+            clearColorKnown = false;
+        }
+    };
+
+    State state;
+    GLState::Stats stats;
+
+    int textureTargetIndex(unsigned int target)
+    {
+        switch (target)
+        {
+        case GL_TEXTURE_2D:
+            return TEXTURE_2D;
+        case GL_TEXTURE_2D_ARRAY:
+            return TEXTURE_2D_ARRAY;
+        case GL_TEXTURE_BUFFER:
+            return TEXTURE_BUFFER_TARGET;
+        default:
+            return -1;
+        }
+    }
+
+    int bufferTargetIndex(unsigned int target)
+    {
+        switch (target)
+        {
+        case GL_ARRAY_BUFFER:
+            return ARRAY_BUFFER;
+        case GL_TEXTURE_BUFFER:
+            return TEXTURE_BUFFER_BINDING;
+        case GL_UNIFORM_BUFFER:
+            return UNIFORM_BUFFER;
+        default:
+            return -1;
+        }
+    }
+
+    int capabilityIndex(unsigned int capability)
+    {
+        switch (capability)
+        {
+        case GL_DEPTH_TEST:
+            return DEPTH_TEST;
+        case GL_CULL_FACE:
+            return CULL_FACE;
+        case GL_BLEND:
+            return BLEND;
+        default:
+            return -1;
+        }
+    }
+
+    // Returns true (and counts the call) if 'current' differs from 'wanted', updating it
+    bool change(unsigned int &current, unsigned int wanted)
+    {
+        if (current == wanted)
+        {
+            stats.avoided++;
+            return false;
+        }
+        current = wanted;
+        stats.issued++;
+        return true;
+    }
+
+    void activateUnit(unsigned int unit)
+    {
+        if (change(state.activeUnit, unit))
+            glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+namespace GLState
+{
+    void useProgram(unsigned int program)
+    {
+        if (change(state.program, program))
+            glUseProgram(program);
+    }
+
+    void bindVertexArray(unsigned int vao)
+    {
+        if (change(state.vertexArray, vao))
+            glBindVertexArray(vao);
+    }
+
+    void bindBuffer(unsigned int target, unsigned int buffer)
+    {
+        int index = bufferTargetIndex(target);
+        if (index < 0)
+        {
+            stats.issued++;
+            glBindBuffer(target, buffer);
+            return;
+        }
+        if (change(state.buffers[index], buffer))
+            glBindBuffer(target, buffer);
+    }
+
+    void bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer)
+    {
+        // Indexed bindings are not cached, only the generic binding the call also changes
+        stats.issued++;
+        glBindBufferBase(target, index, buffer);
+        int generic = bufferTargetIndex(target);
+        if (generic >= 0)
+            state.buffers[generic] = buffer;
+    }
+
+    void bindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+    {
+        int index = textureTargetIndex(target);
+        if (index < 0 || unit >= kTextureUnits)
+        {
+            activateUnit(unit);
+            stats.issued++;
+            glBindTexture(target, texture);
+            return;
+        }
+        // Only switch units when the binding actually changes
+        if (state.textures[unit][index] == texture)
+        {
+            stats.avoided++;
+            return;
+        }
+        activateUnit(unit);
+        change(state.textures[unit][index], texture);
+        glBindTexture(target, texture);
+    }
+
+    void setEnabled(unsigned int capability, bool enabled)
+    {
+        int index = capabilityIndex(capability);
+        if (index >= 0 && state.capabilities[index] == (enabled ? 1 : 0))
+        {
+            stats.avoided++;
+            return;
+        }
+        if (index >= 0)
+            state.capabilities[index] = enabled ? 1 : 0;
+        stats.issued++;
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+
+    void setClearColor(float r, float g, float b, float a)
+    {
+        const float color[4] = {r, g, b, a};
+        if (state.clearColorKnown && color[0] == state.clearColor[0] && color[1] == state.clearColor[1] &&
+            color[2] == state.clearColor[2] && color[3] == state.clearColor[3])
+        {
+            stats.avoided++;
+            return;
+        }
+        for (int i = 0; i < 4; ++i)
+            state.clearColor[i] = color[i];
+        state.clearColorKnown = true;
+        stats.issued++;
+        glClearColor(r, g, b, a);
+    }
+
+    void programDeleted(unsigned int program)
+    {
+        if (state.program == program)
+            state.program = kUnknown;
+    }
+
+    void vertexArrayDeleted(unsigned int vao)
+    {
+        if (state.vertexArray == vao)
+            state.vertexArray = kUnknown;
+    }
+
+    void bufferDeleted(unsigned int buffer)
+    {
+        for (unsigned int &bound : state.buffers)
+        {
+            if (bound == buffer)
+                bound = kUnknown;
+        }
+    }
+
+    void textureDeleted(unsigned int texture)
+    {
+        for (auto &unit : state.textures)
+            for (unsigned int &bound : unit)
+            {
+                if (bound == texture)
+                    bound = kUnknown;
+            }
+    }
+
+    void invalidate()
+    {
+        state.forget();
+    }
+
+    const Stats &getStats()
+    {
+        return stats;
+    }
+
+    void resetStats()
+    {
+        stats = Stats();
+    }
+
+    void reportStats(std::ostream &out, uint64_t frames)
+    {
+        if (frames == 0)
+            return;
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << std::fixed << std::setprecision(1) << "  GL state calls: " << static_cast<double>(stats.issued) / frames
+            << "/frame issued, " << static_cast<double>(stats.avoided) / frames << "/frame avoided" << std::endl;
+        out.flags(flags);
+        out.precision(precision);
+    }
+}
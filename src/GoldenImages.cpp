@@ -0,0 +1,237 @@
+#include "GoldenImages.h"
+#include "World.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    // --- PNG writing ---
+    // Deflate "stored" blocks keep the writer dependency-free; goldens are small enough
+    // that the missing compression does not matter.
+
+    uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0)
+    {
+        static uint32_t table[256] = {};
+        if (table[1] == 0)
+        {
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                table[n] = c;
+            }
+        }
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    void putBigEndian(std::vector<uint8_t> &out, uint32_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void writeChunk(std::ofstream &file, const char type[4], const std::vector<uint8_t> &data)
+    {
+        std::vector<uint8_t> chunk;
+        putBigEndian(chunk, static_cast<uint32_t>(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        putBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+        file.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+    }
+
+    // --- Perceptual difference (YIQ, as used by common image diff tools) ---
+    constexpr double kMaxYiqDelta = 35215.0; // Delta between black and white
+
+    double yiqDelta(const uint8_t *a, const uint8_t *b)
+    {
+        double dr = static_cast<double>(a[0]) - b[0];
+        double dg = static_cast<double>(a[1]) - b[1];
+        double db = static_cast<double>(a[2]) - b[2];
+        double y = dr * 0.29889531 + dg * 0.58662247 + db * 0.11448223;
+        double i = dr * 0.59597799 - dg * 0.27417610 - db * 0.32180189;
+        double q = dr * 0.21147017 - dg * 0.52261711 + db * 0.31114694;
+        return 0.5053 * y * y + 0.299 * i * i + 0.1957 * q * q;
+    }
+}
+
+namespace GoldenImages
+{
+    const std::vector<Case> &cases()
+    {
+        static const std::vector<Case> all = {
+            {"default_start", Scene::DEFAULT, glm::vec3(5.0f, 5.0f, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f)},
+            {"default_overview", Scene::DEFAULT, glm::vec3(-6.0f, 12.0f, -6.0f), glm::vec3(8.0f, 0.0f, 8.0f)},
+            {"terrain_overview", Scene::TERRAIN, glm::vec3(-4.0f, 14.0f, -4.0f), glm::vec3(8.0f, 3.0f, 8.0f), 8.0f},
+            {"terrain_ground", Scene::TERRAIN, glm::vec3(2.5f, 10.5f, 14.5f), glm::vec3(12.0f, 6.0f, 4.0f)},
+            {"stress_outside", Scene::STRESS, glm::vec3(-8.0f, 20.0f, -8.0f), glm::vec3(8.0f, 8.0f, 8.0f), 8.0f},
+            {"stress_inside", Scene::STRESS, glm::vec3(7.5f, 8.5f, 6.5f), glm::vec3(15.0f, 4.0f, 12.0f)},
+        };
+        return all;
+    }
+
+    void buildTerrainScene(World &world)
+    {
+        for (int z = 0; z < WORLD_DEPTH; ++z)
+        {
+            for (int x = 0; x < WORLD_WIDTH; ++x)
+            {
+                // Fixed rolling hills between heights 2 and 8
+                int height = 5 + static_cast<int>(std::lround(2.0 * std::sin(x * 0.6) + 1.5 * std::cos(z * 0.45 + x * 0.2)));
+                world.fillRegion(glm::ivec3(x, 0, z), glm::ivec3(x, height - 3, z), BlockType::STONE);
+                world.fillRegion(glm::ivec3(x, height - 2, z), glm::ivec3(x, height - 1, z), BlockType::DIRT);
+                world.addBlock(x, height, z, height <= 3 ? BlockType::SAND : BlockType::GRASS);
+            }
+        }
+
+        // A tree on the hill at (11, 11)
+        int base = 1;
+        while (base < WORLD_HEIGHT && world.isSolid(11, base, 11))
+            ++base;
+        world.fillRegion(glm::ivec3(11, base, 11), glm::ivec3(11, base + 3, 11), BlockType::WOOD_OAK);
+        world.fillRegion(glm::ivec3(10, base + 3, 10), glm::ivec3(12, base + 4, 12), BlockType::OAK_LEAF);
+        world.addBlock(11, base + 5, 11, BlockType::OAK_LEAF);
+        world.replaceInRegion(glm::ivec3(11, base + 3, 11), glm::ivec3(11, base + 4, 11), BlockType::OAK_LEAF, BlockType::WOOD_OAK);
+    }
+
+    void buildStressScene(World &world)
+    {
+        const BlockType palette[] = {BlockType::STONE, BlockType::COBBLESTONE, BlockType::OAK_PLANK, BlockType::SAND};
+        for (int y = 0; y < WORLD_HEIGHT; ++y)
+        {
+            for (int z = 0; z < WORLD_DEPTH; ++z)
+            {
+                for (int x = 0; x < WORLD_WIDTH; ++x)
+                {
+                    if ((x + y + z) % 2 == 0)
+                        world.addBlock(x, y, z, palette[(x / 2 + y / 2 + z / 2) % 4]);
+                }
+            }
+        }
+    }
+
+    bool writePng(const std::string &path, const RgbImage &image)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        file.write(reinterpret_cast<const char *>(signature), sizeof(signature));
+
+        std::vector<uint8_t> header;
+        putBigEndian(header, static_cast<uint32_t>(image.width));
+        putBigEndian(header, static_cast<uint32_t>(image.height));
+        header.insert(header.end(), {8, 2, 0, 0, 0}); // 8 bit, RGB, deflate, adaptive filtering, no interlace
+        writeChunk(file, "IHDR", header);
+
+        // Scanlines with filter type 0 (none)
+        const size_t rowBytes = static_cast<size_t>(image.width) * 3;
+        std::vector<uint8_t> raw;
+        raw.reserve((rowBytes + 1) * image.height);
+        for (int y = 0; y < image.height; ++y)
+        {
+            raw.push_back(0);
+            raw.insert(raw.end(), image.pixels.begin() + y * rowBytes, image.pixels.begin() + (y + 1) * rowBytes);
+        }
+
+        // zlib stream of stored blocks, then the Adler-32 of the raw data
+        std::vector<uint8_t> zlib = {0x78, 0x01};
+        for (size_t offset = 0; offset < raw.size() || offset == 0; offset += 65535)
+        {
+            size_t length = std::min<size_t>(65535, raw.size() - offset);
+            zlib.push_back(offset + length >= raw.size() ? 1 : 0);
+            zlib.push_back(static_cast<uint8_t>(length));
+            zlib.push_back(static_cast<uint8_t>(length >> 8));
+            zlib.push_back(static_cast<uint8_t>(~length));
+            zlib.push_back(static_cast<uint8_t>(~length >> 8));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+        }
+        uint32_t a = 1, b = 0;
+        for (uint8_t byte : raw)
+        {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        putBigEndian(zlib, (b << 16) | a);
+        writeChunk(file, "IDAT", zlib);
+        writeChunk(file, "IEND", std::vector<uint8_t>());
+        return static_cast<bool>(file);
+    }
+
+    bool readPng(const std::string &path, RgbImage &image)
+    {
+        stbi_set_flip_vertically_on_load(false);
+        int width, height, channels;
+        unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 3);
+        stbi_set_flip_vertically_on_load(true); // Restore what the texture loading code expects
+        if (!data)
+            return false;
+        image.width = width;
+        image.height = height;
+        image.pixels.assign(data, data + static_cast<size_t>(width) * height * 3);
+        stbi_image_free(data);
+        return true;
+    }
+
+    Difference compareImages(const RgbImage &a, const RgbImage &b, double threshold)
+    {
+        Difference result;
+        size_t pixelCount = static_cast<size_t>(a.width) * a.height;
+        if (a.width != b.width || a.height != b.height)
+        {
+            result.differingPixels = pixelCount;
+            result.differingPercent = 100.0;
+            result.maxDelta = 1.0;
+            return result;
+        }
+
+        const double limit = kMaxYiqDelta * threshold * threshold;
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            double delta = yiqDelta(&a.pixels[i * 3], &b.pixels[i * 3]);
+            if (delta > limit)
+                result.differingPixels++;
+            result.maxDelta = std::max(result.maxDelta, std::sqrt(delta / kMaxYiqDelta));
+        }
+        result.differingPercent = pixelCount ? 100.0 * result.differingPixels / pixelCount : 0.0;
+        return result;
+    }
+
+    std::map<std::string, double> readTimings(const std::string &path)
+    {
+        std::map<std::string, double> timings;
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line); // header
+        while (std::getline(file, line))
+        {
+            std::istringstream row(line);
+            std::string key, value;
+            if (std::getline(row, key, ',') && std::getline(row, value))
+                timings[key] = std::atof(value.c_str());
+        }
+        return timings;
+    }
+
+    bool writeTimings(const std::string &path, const std::map<std::string, double> &timings)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+            return false;
+        file << "case,median_frame_ms\n";
+        for (const auto &entry : timings)
+            file << entry.first << ',' << entry.second << '\n';
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,75 @@
+#include "GpuTimer.h"
+#include "GLPlatform.h"
+
+#include <cstring>
+
+GpuTimer::GpuTimer()
+{
+    // Timer queries are core since GL 3.3, older contexts need the ARB extension
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    supported_ = major > 3 || (major == 3 && minor >= 3);
+    if (!supported_)
+    {
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount && !supported_; ++i)
+        {
+            const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+            supported_ = name && std::strcmp(name, "GL_ARB_timer_query") == 0;
+        }
+    }
+
+    if (supported_)
+        glGenQueries(kQueryCount, queries_);
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (supported_)
+        glDeleteQueries(kQueryCount, queries_);
+}
+
+void GpuTimer::begin()
+{
+    // If the GPU is more than kQueryCount frames behind, the slot is still busy: skip
+    // this measurement rather than block waiting for the old result.
+    if (!supported_ || active_ || pending_[next_])
+        return;
+    glBeginQuery(GL_TIME_ELAPSED, queries_[next_]);
+    active_ = true;
+}
+
+void GpuTimer::end()
+{
+    if (!active_)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    pending_[next_] = true;
+    next_ = (next_ + 1) % kQueryCount;
+    active_ = false;
+}
+
+double GpuTimer::collect()
+{
+    double result = -1.0;
+    // Queries complete in submission order, so stop at the first unfinished one
+    while (pending_[oldest_])
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(queries_[oldest_], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(queries_[oldest_], GL_QUERY_RESULT, &elapsedNs);
+        // Some drivers (Mesa llvmpipe) time the very first query from an undefined start, drop it
+        if (hasResult_)
+            result = static_cast<double>(elapsedNs) / 1.0e6;
+        hasResult_ = true;
+        pending_[oldest_] = false;
+        oldest_ = (oldest_ + 1) % kQueryCount;
+    }
+    return result;
+}
@@ -0,0 +1,152 @@
+#include "HeadlessContext.h"
+#include "GLPlatform.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#ifdef ENABLE_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext(int width, int height) : width_(width), height_(height)
+{
+    try
+    {
+        createContext();
+        createFramebuffer();
+    }
+    catch (...)
+    {
+        destroy();
+        throw;
+    }
+
+    std::cout << "Headless OpenGL Version: " << glGetString(GL_VERSION)
+              << " (" << glGetString(GL_RENDERER) << ")" << std::endl;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    destroy();
+    std::cout << "Headless context cleaned up." << std::endl;
+}
+
+void HeadlessContext::bindFramebuffer() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+}
+
+void HeadlessContext::finishFrame() const
+{
+    glFinish();
+}
+
+#ifdef ENABLE_HEADLESS
+
+void HeadlessContext::createContext()
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // Prefer Mesa's surfaceless platform: it needs no X11/Wayland server or DRM device
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay && clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless"))
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+        throw std::runtime_error("Failed to initialize an EGL display");
+    display_ = display;
+
+    const char *displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!displayExtensions || !std::strstr(displayExtensions, "EGL_KHR_surfaceless_context"))
+        throw std::runtime_error("EGL display does not support surfaceless contexts");
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+        throw std::runtime_error("EGL cannot create desktop OpenGL contexts");
+
+    // No surface is ever created, so any surface type is acceptable
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, 0,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE};
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+        throw std::runtime_error("No suitable EGL config for an OpenGL context");
+
+    // Same version and profile the windowed build asks GLFW for
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT)
+        throw std::runtime_error("Failed to create an OpenGL 3.3 core EGL context");
+    context_ = context;
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+        throw std::runtime_error("Failed to make the EGL context current");
+}
+
+void HeadlessContext::destroy()
+{
+    if (context_)
+    {
+        if (fbo_)
+        {
+            glDeleteFramebuffers(1, &fbo_);
+            glDeleteRenderbuffers(1, &colorBuffer_);
+            glDeleteRenderbuffers(1, &depthBuffer_);
+            fbo_ = 0;
+        }
+        eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display_, context_);
+        context_ = nullptr;
+    }
+    if (display_)
+    {
+        eglTerminate(display_);
+        display_ = nullptr;
+    }
+}
+
+#else
+
+void HeadlessContext::createContext()
+{
+    throw std::runtime_error("Headless rendering is not compiled in, rebuild with 'make HEADLESS=1'");
+}
+
+void HeadlessContext::destroy()
+{
+}
+
+#endif // ENABLE_HEADLESS
+
+void HeadlessContext::createFramebuffer()
+{
+    glGenRenderbuffers(1, &colorBuffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width_, height_);
+
+    glGenRenderbuffers(1, &depthBuffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width_, height_);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer_);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        throw std::runtime_error("Offscreen framebuffer is incomplete (status " + std::to_string(status) + ")");
+
+    glViewport(0, 0, width_, height_);
+}
@@ -0,0 +1,152 @@
+#include "InputRecording.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const char kMagic[4] = {'V', 'X', 'I', 'N'};
+    constexpr uint32_t kVersion = 1;
+    constexpr size_t kHeaderSize = 16; // magic, version, fixed timestep (double)
+    constexpr size_t kFrameSize = 11;  // key bits (1), ticks (2), mouse dx/dy (4 + 4)
+
+    // Ticks are stored in 16 bits; the loop clamps frame time to 0.25 s so this never overflows
+    constexpr uint32_t kMaxTicks = 0xFFFF;
+
+    enum KeyBit : uint8_t
+    {
+        KEY_FORWARD = 1 << 0,
+        KEY_BACKWARD = 1 << 1,
+        KEY_LEFT = 1 << 2,
+        KEY_RIGHT = 1 << 3,
+        KEY_UP = 1 << 4,
+        KEY_DOWN = 1 << 5,
+        KEY_TOGGLE_FLY = 1 << 6,
+    };
+
+    // Fixed little-endian encoding so recordings are portable between machines
+    void putU16(unsigned char *out, uint32_t value)
+    {
+        out[0] = static_cast<unsigned char>(value);
+        out[1] = static_cast<unsigned char>(value >> 8);
+    }
+
+    void putU32(unsigned char *out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    void putU64(unsigned char *out, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+
+    uint32_t getU16(const unsigned char *in)
+    {
+        return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8);
+    }
+
+    uint32_t getU32(const unsigned char *in)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= static_cast<uint32_t>(in[i]) << (8 * i);
+        return value;
+    }
+
+    uint64_t getU64(const unsigned char *in)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        return value;
+    }
+
+    template <typename To, typename From>
+    To bitCast(From from)
+    {
+        static_assert(sizeof(To) == sizeof(From), "bitCast size mismatch");
+        To to;
+        std::memcpy(&to, &from, sizeof(To));
+        return to;
+    }
+}
+
+InputRecorder::InputRecorder(const std::string &path, double fixedTimestep)
+    : file_(path, std::ios::binary | std::ios::trunc)
+{
+    if (!file_)
+        throw std::runtime_error("Failed to create input recording: " + path);
+
+    unsigned char header[kHeaderSize];
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    putU32(header + 4, kVersion);
+    putU64(header + 8, bitCast<uint64_t>(fixedTimestep));
+    file_.write(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+InputRecorder::~InputRecorder()
+{
+    file_.flush();
+}
+
+void InputRecorder::recordFrame(const InputFrame &frame)
+{
+    const InputState &in = frame.input;
+    uint8_t keys = (in.forward ? KEY_FORWARD : 0) | (in.backward ? KEY_BACKWARD : 0) |
+                   (in.left ? KEY_LEFT : 0) | (in.right ? KEY_RIGHT : 0) |
+                   (in.up ? KEY_UP : 0) | (in.down ? KEY_DOWN : 0) |
+                   (in.toggleFly ? KEY_TOGGLE_FLY : 0);
+
+    unsigned char record[kFrameSize];
+    record[0] = keys;
+    putU16(record + 1, frame.ticks > kMaxTicks ? kMaxTicks : frame.ticks);
+    putU32(record + 3, bitCast<uint32_t>(in.mouseDX));
+    putU32(record + 7, bitCast<uint32_t>(in.mouseDY));
+    file_.write(reinterpret_cast<const char *>(record), sizeof(record));
+    ++frameCount_;
+}
+
+InputPlayback::InputPlayback(const std::string &path, double fixedTimestep)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open input recording: " + path);
+
+    unsigned char header[kHeaderSize];
+    if (!file.read(reinterpret_cast<char *>(header), sizeof(header)) || std::memcmp(header, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("Not an input recording: " + path);
+    if (getU32(header + 4) != kVersion)
+        throw std::runtime_error("Unsupported input recording version in " + path);
+    // A different timestep would simulate different physics from the same inputs
+    if (bitCast<double>(getU64(header + 8)) != fixedTimestep)
+        throw std::runtime_error("Input recording " + path + " was made with a different fixed timestep");
+
+    unsigned char record[kFrameSize];
+    while (file.read(reinterpret_cast<char *>(record), sizeof(record)))
+    {
+        InputFrame frame;
+        uint8_t keys = record[0];
+        frame.input.forward = (keys & KEY_FORWARD) != 0;
+        frame.input.backward = (keys & KEY_BACKWARD) != 0;
+        frame.input.left = (keys & KEY_LEFT) != 0;
+        frame.input.right = (keys & KEY_RIGHT) != 0;
+        frame.input.up = (keys & KEY_UP) != 0;
+        frame.input.down = (keys & KEY_DOWN) != 0;
+        frame.input.toggleFly = (keys & KEY_TOGGLE_FLY) != 0;
+        frame.ticks = getU16(record + 1);
+        frame.input.mouseDX = bitCast<float>(getU32(record + 3));
+        frame.input.mouseDY = bitCast<float>(getU32(record + 7));
+        frames_.push_back(frame);
+    }
+}
+
+bool InputPlayback::nextFrame(InputFrame &frame)
+{
+    if (finished())
+        return false;
+    frame = frames_[next_++];
+    return true;
+}
@@ -0,0 +1,60 @@
+#include "InstanceBuffer.h"
+#include "Mesh.h"
+#include "GLState.h"
+#include "GLPlatform.h"
+#include <cstddef>
+
+namespace
+{
+    constexpr unsigned int kModelLocation = 4; // mat4 takes locations 4, 5, 6, 7
+    constexpr unsigned int kLayerLocation = 8;
+}
+
+InstanceBuffer::InstanceBuffer()
+{
+    glGenBuffers(1, &VBO);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+    glDeleteBuffers(1, &VBO);
+    GLState::bufferDeleted(VBO);
+}
+
+void InstanceBuffer::attachTo(const Mesh &mesh) const
+{
+    mesh.bind();
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    for (unsigned int column = 0; column < 4; ++column)
+    {
+        unsigned int location = kModelLocation + column;
+        size_t offset = offsetof(InstanceData, model) + column * sizeof(glm::vec4);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)offset);
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1); // Advance once per instance, not per vertex
+    }
+
+    glVertexAttribPointer(kLayerLocation, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)offsetof(InstanceData, layer));
+    glEnableVertexAttribArray(kLayerLocation);
+    glVertexAttribDivisor(kLayerLocation, 1);
+
+    mesh.unbind();
+}
+
+void InstanceBuffer::upload(const std::vector<InstanceData> &instances)
+{
+    count = instances.size();
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    // Grow geometrically so a slowly rising instance count does not reallocate every frame
+    if (count > capacity)
+    {
+        capacity = count + count / 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(InstanceData), NULL, GL_STREAM_DRAW); // orphan
+    if (count > 0)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData), instances.data());
+    }
+}
@@ -0,0 +1,272 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <iomanip>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    // Which JobSystem (if any) the current thread belongs to, and its index there
+    thread_local const JobSystem *currentSystem = nullptr;
+    thread_local unsigned int currentIndex = 0;
+
+    uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // CPUs this process may run on, in order. Empty where affinity is not supported
+    // (macOS only offers scheduling hints), in which case workers are not pinned.
+    std::vector<int> allowedCpus()
+    {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                    cpus.push_back(cpu);
+            }
+        }
+#endif
+        return cpus;
+    }
+
+    void pinThread(std::thread &thread, int cpu)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set); // Best effort
+#else
+        (void)thread;
+        (void)cpu;
+#endif
+    }
+}
+
+JobSystem::JobSystem(unsigned int threadCount)
+    : statsStart_(std::chrono::steady_clock::now())
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < threadCount; ++i)
+        queues_.push_back(std::make_unique<ThreadQueue>());
+
+    currentSystem = this;
+    currentIndex = 0;
+
+    // The main thread stays unpinned (the GL driver has its own threads to schedule around
+    // it); workers take the allowed CPUs after the first
+    std::vector<int> cpus = allowedCpus();
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+        workers_.emplace_back(&JobSystem::workerLoop, this, i);
+        if (cpus.size() >= threadCount)
+            pinThread(workers_.back(), cpus[i]);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wakeWorkers_.notify_all();
+    for (std::thread &worker : workers_)
+        worker.join();
+    if (currentSystem == this)
+        currentSystem = nullptr;
+}
+
+unsigned int JobSystem::getCurrentThreadIndex() const
+{
+    return currentSystem == this ? currentIndex : 0;
+}
+
+void JobSystem::run(Job job, JobCounter *counter)
+{
+    if (counter)
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    ThreadQueue &queue = *queues_[getCurrentThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(QueuedJob{std::move(job), counter});
+    }
+    queuedJobs_.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this with a worker that checked queuedJobs_ and is about to sleep
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wakeWorkers_.notify_one();
+}
+
+void JobSystem::wait(const JobCounter &counter)
+{
+    const unsigned int self = getCurrentThreadIndex();
+    while (!counter.isDone())
+    {
+        if (!runOneJob(self))
+            std::this_thread::yield(); // The remaining jobs are running on other threads
+    }
+    // Every job has finished, so nothing writes 'error' any more
+    if (counter.error)
+        std::rethrow_exception(counter.error);
+}
+
+bool JobSystem::takeJob(unsigned int self, QueuedJob &job, bool &stolen)
+{
+    {
+        ThreadQueue &own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            stolen = false;
+            return true;
+        }
+    }
+
+    const size_t count = queues_.size();
+    for (size_t offset = 1; offset < count; ++offset)
+    {
+        ThreadQueue &victim = *queues_[(self + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::runOneJob(unsigned int self)
+{
+    if (queuedJobs_.load(std::memory_order_acquire) == 0)
+        return false;
+
+    QueuedJob job;
+    bool stolen = false;
+    if (!takeJob(self, job, stolen))
+        return false;
+    queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+
+    auto start = std::chrono::steady_clock::now();
+    std::exception_ptr error;
+    try
+    {
+        job.job();
+    }
+    catch (...)
+    {
+        // Handed to wait() below; the counter must still drop or its waiter never returns
+        error = std::current_exception();
+    }
+    ThreadQueue &stats = *queues_[self];
+    stats.busyNs.fetch_add(nanosecondsSince(start), std::memory_order_relaxed);
+    stats.jobsRun.fetch_add(1, std::memory_order_relaxed);
+    if (stolen)
+        stats.jobsStolen.fetch_add(1, std::memory_order_relaxed);
+
+    if (job.counter)
+    {
+        if (error)
+        {
+            std::lock_guard<std::mutex> lock(job.counter->errorMutex);
+            if (!job.counter->error)
+                job.counter->error = error;
+        }
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+    else if (error)
+    {
+        std::rethrow_exception(error); // Nobody waits for this job, same as before
+    }
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned int index)
+{
+    currentSystem = this;
+    currentIndex = index;
+    PROFILE_THREAD_NAME("Job worker");
+
+    for (;;)
+    {
+        if (runOneJob(index))
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wakeWorkers_.wait(lock, [this]
+                          { return stopping_ || queuedJobs_.load(std::memory_order_acquire) > 0; });
+        if (stopping_)
+            return;
+    }
+}
+
+std::vector<JobSystem::ThreadStats> JobSystem::getThreadStats() const
+{
+    std::vector<ThreadStats> stats(queues_.size());
+    for (size_t i = 0; i < queues_.size(); ++i)
+    {
+        stats[i].jobsRun = queues_[i]->jobsRun.load(std::memory_order_relaxed);
+        stats[i].jobsStolen = queues_[i]->jobsStolen.load(std::memory_order_relaxed);
+        stats[i].busyMs = queues_[i]->busyNs.load(std::memory_order_relaxed) / 1.0e6;
+    }
+    return stats;
+}
+
+double JobSystem::getStatsWindowMs() const
+{
+    return nanosecondsSince(statsStart_) / 1.0e6;
+}
+
+void JobSystem::resetStats()
+{
+    for (const std::unique_ptr<ThreadQueue> &queue : queues_)
+    {
+        queue->jobsRun.store(0, std::memory_order_relaxed);
+        queue->jobsStolen.store(0, std::memory_order_relaxed);
+        queue->busyNs.store(0, std::memory_order_relaxed);
+    }
+    statsStart_ = std::chrono::steady_clock::now();
+}
+
+void JobSystem::reportStats(std::ostream &out) const
+{
+    std::vector<ThreadStats> stats = getThreadStats();
+    double windowMs = getStatsWindowMs();
+    if (windowMs <= 0.0)
+        return;
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1) << "  Job threads (" << stats.size() << "):";
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        if (i == 0)
+            out << " main ";
+        else
+            out << ", w" << i << ' ';
+        out << 100.0 * stats[i].busyMs / windowMs << "% (" << stats[i].jobsRun << " jobs, " << stats[i].jobsStolen << " stolen)";
+    }
+    out << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
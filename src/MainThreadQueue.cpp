@@ -0,0 +1,154 @@
+#include "MainThreadQueue.h"
+#include "Profiler.h"
+
+#include <chrono>
+#include <utility>
+
+MainThreadQueue::MainThreadQueue()
+    : head_(&stub_), tail_(&stub_)
+{
+}
+
+MainThreadQueue::~MainThreadQueue()
+{
+    clear();
+}
+
+void MainThreadQueue::submit(Task task, TaskPriority priority, uint64_t coalescingKey)
+{
+    Node *node = new Node();
+    node->task = std::move(task);
+    node->key = coalescingKey;
+    node->priority = priority;
+    push(node);
+}
+
+void MainThreadQueue::push(Node *node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    // Claim the head, then link the previous head to us. Between the two steps the list is
+    // briefly broken; pop() sees that as "empty for now" and picks the node up next time.
+    Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+MainThreadQueue::Node *MainThreadQueue::pop()
+{
+    Node *tail = tail_;
+    Node *next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_)
+    {
+        if (!next)
+            return nullptr;
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next)
+    {
+        tail_ = next;
+        return tail;
+    }
+
+    // 'tail' is the last linked node. Unless a producer is mid-push, re-insert the stub behind
+    // it so it can be handed out without leaving the list empty.
+    if (tail != head_.load(std::memory_order_acquire))
+        return nullptr;
+    push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        tail_ = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void MainThreadQueue::collectSubmitted()
+{
+    // Pop order is submission order, so every node replaces older ones with its key
+    while (Node *node = pop())
+    {
+        if (node->key != kNoCoalescing)
+        {
+            auto [it, inserted] = latestByKey_.emplace(node->key, node);
+            if (!inserted)
+            {
+                it->second->task = nullptr; // Stays in its list and is skipped when reached
+                it->second = node;
+                stats_.coalesced++;
+            }
+        }
+        pending_[static_cast<int>(node->priority)].push_back(node);
+    }
+}
+
+size_t MainThreadQueue::drain(double budgetMs)
+{
+    PROFILE_SCOPE("DrainMainThreadTasks");
+    collectSubmitted();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t executed = 0;
+    for (std::deque<Node *> &tasks : pending_)
+    {
+        while (!tasks.empty())
+        {
+            if (executed > 0 && std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() >= budgetMs)
+            {
+                stats_.deferred++;
+                return executed;
+            }
+
+            Node *node = tasks.front();
+            tasks.pop_front();
+            if (node->task)
+            {
+                if (node->key != kNoCoalescing)
+                    latestByKey_.erase(node->key);
+                // The node is freed first so a throwing task does not leak it
+                Task task = std::move(node->task);
+                delete node;
+                task();
+                ++executed;
+                stats_.executed++;
+            }
+            else
+            {
+                delete node; // Superseded
+            }
+        }
+    }
+    return executed;
+}
+
+size_t MainThreadQueue::drainAll()
+{
+    size_t executed = 0;
+    while (size_t ran = drain(1.0e30))
+        executed += ran;
+    return executed;
+}
+
+void MainThreadQueue::clear()
+{
+    collectSubmitted();
+    for (std::deque<Node *> &tasks : pending_)
+    {
+        for (Node *node : tasks)
+            delete node;
+        tasks.clear();
+    }
+    latestByKey_.clear();
+}
+
+size_t MainThreadQueue::pendingCount() const
+{
+    size_t count = 0;
+    for (const std::deque<Node *> &tasks : pending_)
+    {
+        for (const Node *node : tasks)
+            count += node->task ? 1 : 0;
+    }
+    return count;
+}
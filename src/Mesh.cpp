@@ -1,28 +1,66 @@
 #include "Mesh.h"
+#include "QuadIndexBuffer.h"
+#include "GLState.h"
+#include "GLPlatform.h"
+#include <cstdint>
 #include <cstddef>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
-#ifdef __APPLE__
-#include <OpenGL/gl3.h>
-#endif
-
 Mesh::Mesh(const float *vertices, size_t vertexSize, const unsigned int *indices, size_t indexSize, size_t vertexStride, const std::vector<std::tuple<unsigned int, size_t, int>> &attributeLayout)
+    : ownsIndexBuffer(true)
 {
     indexCount = indexSize / sizeof(unsigned int);
+    size_t vertexCount = vertexStride ? vertexSize / vertexStride : 0;
+
+    setupVertexArray(vertices, vertexSize, vertexStride, attributeLayout);
+
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    if (vertexCount <= 65536)
+    {
+        // Half the index memory and bandwidth
+        std::vector<uint16_t> shortIndices(indices, indices + indexCount);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(), GL_STATIC_DRAW);
+        indexType = GL_UNSIGNED_SHORT;
+    }
+    else
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize, indices, GL_STATIC_DRAW);
+        indexType = GL_UNSIGNED_INT;
+    }
+
+    GLState::bindVertexArray(0); // Unbind VAO so later buffer binds cannot change it
+}
+
+Mesh::Mesh(const float *vertices, size_t vertexSize, const QuadIndexBuffer &quadIndices, size_t quadCount, size_t vertexStride, const std::vector<std::tuple<unsigned int, size_t, int>> &attributeLayout,
+           const std::vector<std::tuple<unsigned int, size_t, int>> &integerAttributeLayout)
+    : ownsIndexBuffer(false)
+{
+    if (quadCount > QuadIndexBuffer::kMaxQuads)
+        throw std::runtime_error("Mesh has more quads than the shared quad index buffer covers.");
+
+    indexCount = static_cast<unsigned int>(quadCount * 6);
+    indexType = GL_UNSIGNED_SHORT;
+    EBO = quadIndices.getBufferId();
 
+    setupVertexArray(vertices, vertexSize, vertexStride, attributeLayout, integerAttributeLayout);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO); // Recorded in the VAO
+    GLState::bindVertexArray(0);
+}
+
+void Mesh::setupVertexArray(const float *vertices, size_t vertexSize, size_t vertexStride, const std::vector<std::tuple<unsigned int, size_t, int>> &attributeLayout,
+                            const std::vector<std::tuple<unsigned int, size_t, int>> &integerAttributeLayout)
+{
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
 
-    glBindVertexArray(VAO);
+    GLState::bindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertexSize, vertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize, indices, GL_STATIC_DRAW);
-
     for (const auto &attr : attributeLayout)
     {
         unsigned int location = std::get<0>(attr);
@@ -33,23 +71,34 @@ Mesh::Mesh(const float *vertices, size_t vertexSize, const unsigned int *indices
         glEnableVertexAttribArray(location);
     }
 
-    glBindVertexArray(0); // Unbind VAO
-    // Note: VBO and EBO are unbound when VAO is unbound
+    // Integer attributes keep their bits (no conversion to float), the shader decodes them
+    for (const auto &attr : integerAttributeLayout)
+    {
+        unsigned int location = std::get<0>(attr);
+        size_t offset = std::get<1>(attr);
+        int size = std::get<2>(attr);
+
+        glVertexAttribIPointer(location, size, GL_UNSIGNED_INT, vertexStride, (void *)offset);
+        glEnableVertexAttribArray(location);
+    }
 }
 
 Mesh::~Mesh()
 {
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    GLState::vertexArrayDeleted(VAO);
+    GLState::bufferDeleted(VBO);
+    if (ownsIndexBuffer)
+        glDeleteBuffers(1, &EBO);
 }
 
 void Mesh::bind() const
 {
-    glBindVertexArray(VAO);
+    GLState::bindVertexArray(VAO);
 }
 
 void Mesh::unbind() const
 {
-    glBindVertexArray(0);
+    GLState::bindVertexArray(0);
 }
\ No newline at end of file
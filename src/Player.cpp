@@ -0,0 +1,154 @@
+#include "Player.h"
+#include "World.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Gap kept between the player and any wall so floating point error never lets the box re-enter a voxel
+    constexpr float kSkin = 1e-4f;
+    // Falling below this height (out of the world) puts the player back at the spawn point
+    constexpr float kKillPlaneY = -64.0f;
+}
+
+Player::Player(const glm::vec3 &feetPosition) : position(feetPosition), spawnPoint_(feetPosition) {}
+
+glm::vec3 Player::getEyePosition() const
+{
+    return position + glm::vec3(0.0f, eyeHeight, 0.0f);
+}
+
+AABB Player::getBounds() const
+{
+    return AABB{
+        position - glm::vec3(halfWidth, 0.0f, halfWidth),
+        position + glm::vec3(halfWidth, height, halfWidth)};
+}
+
+void Player::update(const World &world, const glm::vec3 &wishDir, bool jump, float dt)
+{
+    if (flying)
+    {
+        // Noclip: move straight along the wish direction
+        velocity = wishDir * flySpeed;
+        position += velocity * dt;
+        onGround = false;
+        return;
+    }
+
+    // Horizontal velocity follows the input directly, vertical velocity is integrated
+    velocity.x = wishDir.x * walkSpeed;
+    velocity.z = wishDir.z * walkSpeed;
+    if (jump && onGround)
+        velocity.y = jumpSpeed;
+    velocity.y = std::max(velocity.y - gravity * dt, -terminalVelocity);
+
+    glm::vec3 delta = velocity * dt;
+
+    // Vertical first, so ground state is known before trying to step up
+    float movedY = moveAxis(world, 1, delta.y);
+    bool blockedY = movedY != delta.y;
+    onGround = blockedY && delta.y < 0.0f;
+    if (blockedY)
+        velocity.y = 0.0f;
+
+    glm::vec3 start = position;
+    float movedX = moveAxis(world, 0, delta.x);
+    float movedZ = moveAxis(world, 2, delta.z);
+
+    // Step-up: if a wall stopped us while grounded, retry the horizontal move from
+    // 'stepHeight' higher and keep whichever attempt travelled further.
+    bool blockedH = movedX != delta.x || movedZ != delta.z;
+    if (blockedH && onGround && stepHeight > 0.0f)
+    {
+        glm::vec3 unstepped = position;
+        position = start;
+
+        float lifted = moveAxis(world, 1, stepHeight);
+        float stepX = moveAxis(world, 0, delta.x);
+        float stepZ = moveAxis(world, 2, delta.z);
+        moveAxis(world, 1, -lifted); // settle back down onto the ledge
+
+        if (stepX * stepX + stepZ * stepZ <= movedX * movedX + movedZ * movedZ)
+        {
+            position = unstepped; // Stepping did not help, keep the plain result
+        }
+    }
+
+    if (position.y < kKillPlaneY)
+    {
+        position = spawnPoint_;
+        velocity = glm::vec3(0.0f);
+        onGround = false;
+    }
+}
+
+float Player::moveAxis(const World &world, int axis, float delta)
+{
+    if (delta == 0.0f)
+        return 0.0f;
+
+    AABB box = getBounds();
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+
+    // Voxels covered by the box cross-section on the two other axes
+    int uMin = static_cast<int>(std::floor(box.min[u] + kSkin));
+    int uMax = static_cast<int>(std::floor(box.max[u] - kSkin));
+    int vMin = static_cast<int>(std::floor(box.min[v] + kSkin));
+    int vMax = static_cast<int>(std::floor(box.max[v] - kSkin));
+
+    // Returns true if any voxel of the cross-section at 'layer' along the axis is solid
+    auto layerIsSolid = [&](int layer)
+    {
+        int p[3];
+        p[axis] = layer;
+        for (int a = uMin; a <= uMax; ++a)
+        {
+            p[u] = a;
+            for (int b = vMin; b <= vMax; ++b)
+            {
+                p[v] = b;
+                if (world.isSolid(p[0], p[1], p[2]))
+                    return true;
+            }
+        }
+        return false;
+    };
+
+    // Broadphase: only the voxel layers between the leading face and its destination are
+    // visited, nearest first, so the scan stops at the first obstacle.
+    float moved = delta;
+    if (delta > 0.0f)
+    {
+        float lead = box.max[axis];
+        int first = static_cast<int>(std::ceil(lead - kSkin));
+        int last = static_cast<int>(std::floor(lead + delta));
+        for (int layer = first; layer <= last; ++layer)
+        {
+            if (layerIsSolid(layer))
+            {
+                moved = std::max(0.0f, static_cast<float>(layer) - lead - kSkin);
+                break;
+            }
+        }
+    }
+    else
+    {
+        float lead = box.min[axis];
+        int first = static_cast<int>(std::floor(lead + kSkin)) - 1;
+        int last = static_cast<int>(std::floor(lead + delta));
+        for (int layer = first; layer >= last; --layer)
+        {
+            if (layerIsSolid(layer))
+            {
+                moved = std::min(0.0f, static_cast<float>(layer + 1) - lead + kSkin);
+                break;
+            }
+        }
+    }
+
+    position[axis] += moved;
+    return moved;
+}
@@ -0,0 +1,150 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // Events kept per thread (power of two so the index wraps with a mask)
+    constexpr uint64_t kRingCapacity = 1 << 16;
+
+    struct ZoneEvent
+    {
+        const char *name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Single-producer ring: only the owning thread writes, the exporter reads.
+    // 'written' counts every event ever recorded, so the newest event is at (written - 1).
+    struct ThreadBuffer
+    {
+        ZoneEvent events[kRingCapacity];
+        std::atomic<uint64_t> written{0};
+        std::atomic<const char *> threadName{nullptr};
+        uint32_t threadIndex = 0;
+    };
+
+    // Buffers are never freed, so exporting stays valid after a thread exits.
+    // The mutex only guards registering a new thread, never recording.
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+    ThreadBuffer &threadBuffer()
+    {
+        thread_local ThreadBuffer *buffer = nullptr;
+        if (!buffer)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(std::make_unique<ThreadBuffer>());
+            buffer = registry.back().get();
+            buffer->threadIndex = static_cast<uint32_t>(registry.size());
+        }
+        return *buffer;
+    }
+
+    void writeJsonString(std::ostream &out, const char *text)
+    {
+        out << '"';
+        for (const char *c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                out << '\\';
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+namespace Profiler
+{
+    uint64_t nowNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    void recordZone(const char *name, uint64_t startNs, uint64_t endNs)
+    {
+        ThreadBuffer &buffer = threadBuffer();
+        uint64_t index = buffer.written.load(std::memory_order_relaxed);
+        buffer.events[index & (kRingCapacity - 1)] = ZoneEvent{name, startNs, endNs};
+        buffer.written.store(index + 1, std::memory_order_release); // publish the event
+    }
+
+    void setThreadName(const char *name)
+    {
+        threadBuffer().threadName.store(name, std::memory_order_relaxed);
+    }
+
+    bool writeChromeTrace(const std::string &path)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            std::cerr << "Profiler: cannot open " << path << " for writing" << std::endl;
+            return false;
+        }
+
+        std::vector<ThreadBuffer *> buffers;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (auto &buffer : registry)
+                buffers.push_back(buffer.get());
+        }
+
+        out << std::fixed << std::setprecision(3);
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        size_t eventCount = 0;
+        std::vector<ZoneEvent> snapshot;
+        for (ThreadBuffer *buffer : buffers)
+        {
+            const char *threadName = buffer->threadName.load(std::memory_order_relaxed);
+            if (threadName)
+            {
+                out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex << ",\"args\":{\"name\":";
+                writeJsonString(out, threadName);
+                out << "}}";
+                first = false;
+            }
+
+            // Copy the live window of the ring, then re-read the counter. Events the owner
+            // overwrote while we were copying are dropped, and so is the slot it writes next
+            // (index endAfterCopy), which it may be halfway through writing right now.
+            uint64_t end = buffer->written.load(std::memory_order_acquire);
+            uint64_t begin = end > kRingCapacity ? end - kRingCapacity : 0;
+            snapshot.clear();
+            for (uint64_t i = begin; i < end; ++i)
+                snapshot.push_back(buffer->events[i & (kRingCapacity - 1)]);
+            uint64_t endAfterCopy = buffer->written.load(std::memory_order_acquire);
+            uint64_t firstValid = endAfterCopy + 1 > kRingCapacity ? endAfterCopy + 1 - kRingCapacity : 0;
+            size_t skip = static_cast<size_t>(std::min<uint64_t>(firstValid > begin ? firstValid - begin : 0, snapshot.size()));
+
+            for (size_t i = skip; i < snapshot.size(); ++i)
+            {
+                const ZoneEvent &event = snapshot[i];
+                // Chrome trace timestamps are in microseconds
+                out << (first ? "" : ",\n") << "{\"name\":";
+                writeJsonString(out, event.name);
+                out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+                    << ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+                    << ",\"dur\":" << static_cast<double>(event.endNs - event.startNs) / 1000.0 << "}";
+                first = false;
+                ++eventCount;
+            }
+        }
+        out << "\n]}\n";
+
+        std::cout << "Profiler: wrote " << eventCount << " zones to " << path << std::endl;
+        return static_cast<bool>(out);
+    }
+}
@@ -0,0 +1,163 @@
+#include "ProgramCache.h"
+#include "GLPlatform.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    std::string cacheDirectory;
+    ProgramCache::Stats stats;
+    int binaryFormatCount = -1; // Queried on first use
+
+    const char kMagic[4] = {'G', 'L', 'P', 'B'};
+
+    // FNV-1a, 64 bit; good enough to tell sources apart, not meant to resist tampering
+    uint64_t hashBytes(uint64_t hash, const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t hashString(uint64_t hash, const std::string &text)
+    {
+        // Include the terminator so ("ab", "c") and ("a", "bc") differ
+        return hashBytes(hash, text.c_str(), text.size() + 1);
+    }
+
+    std::string glString(GLenum name)
+    {
+        const char *value = reinterpret_cast<const char *>(glGetString(name));
+        return value ? value : "";
+    }
+
+    bool enabled()
+    {
+        if (cacheDirectory.empty())
+            return false;
+        if (binaryFormatCount < 0)
+        {
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            binaryFormatCount = formats;
+            if (formats == 0)
+                std::cout << "Program binaries not supported by the driver, shader cache disabled." << std::endl;
+        }
+        return binaryFormatCount > 0;
+    }
+
+    std::string entryPath(uint64_t key)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return cacheDirectory + "/" + name;
+    }
+}
+
+namespace ProgramCache
+{
+    void setDirectory(const std::string &directory)
+    {
+        cacheDirectory = directory;
+    }
+
+    uint64_t makeKey(const std::string &vertexSource, const std::string &fragmentSource)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        hash = hashString(hash, vertexSource);
+        hash = hashString(hash, fragmentSource);
+        hash = hashString(hash, glString(GL_VENDOR));
+        hash = hashString(hash, glString(GL_RENDERER));
+        hash = hashString(hash, glString(GL_VERSION));
+        return hash;
+    }
+
+    unsigned int load(uint64_t key)
+    {
+        if (!enabled())
+            return 0;
+
+        // Layout: magic, binary format (uint32), binary bytes
+        std::ifstream file(entryPath(key), std::ios::binary);
+        if (!file)
+        {
+            stats.misses++;
+            return 0;
+        }
+        char magic[4] = {};
+        uint32_t format = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char *>(&format), sizeof(format));
+        std::vector<char> binary;
+        if (file && std::char_traits<char>::compare(magic, kMagic, 4) == 0)
+            binary.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (binary.empty())
+        {
+            stats.rejected++;
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            // Usually a driver change the version string did not reveal; recompiling replaces the entry
+            glDeleteProgram(program);
+            stats.rejected++;
+            return 0;
+        }
+        stats.hits++;
+        return program;
+    }
+
+    void store(uint64_t key, unsigned int program)
+    {
+        if (!enabled())
+            return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+        std::vector<char> binary(static_cast<size_t>(length));
+        GLenum format = 0;
+        glGetProgramBinary(program, length, NULL, &format, binary.data());
+
+        std::error_code error;
+        std::filesystem::create_directories(cacheDirectory, error);
+        // Written under a temporary name and renamed, so a crash never leaves half an entry
+        const std::string path = entryPath(key);
+        const std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            uint32_t format32 = format;
+            file.write(kMagic, sizeof(kMagic));
+            file.write(reinterpret_cast<const char *>(&format32), sizeof(format32));
+            file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+            if (!file)
+            {
+                std::cerr << "Shader cache: could not write " << temporaryPath << std::endl;
+                return;
+            }
+        }
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+            std::cerr << "Shader cache: could not write " << path << std::endl;
+    }
+
+    const Stats &getStats()
+    {
+        return stats;
+    }
+}
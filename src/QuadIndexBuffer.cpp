@@ -0,0 +1,34 @@
+#include "QuadIndexBuffer.h"
+#include "GLPlatform.h"
+
+#include <cstdint>
+#include <vector>
+
+QuadIndexBuffer::QuadIndexBuffer()
+{
+    std::vector<uint16_t> indices;
+    indices.reserve(kMaxQuads * 6);
+    for (size_t quad = 0; quad < kMaxQuads; ++quad)
+    {
+        uint16_t base = static_cast<uint16_t>(quad * 4);
+        indices.push_back(base + 0);
+        indices.push_back(base + 1);
+        indices.push_back(base + 2);
+        indices.push_back(base + 0);
+        indices.push_back(base + 2);
+        indices.push_back(base + 3);
+    }
+
+    // The element array binding is VAO state, and a core profile has no default VAO to hold it
+    // (binding it with VAO 0 is an error on strict drivers). Upload through the copy-write
+    // target instead; each Mesh/QuadMesh binds it as its element array inside its own VAO.
+    glGenBuffers(1, &EBO_);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO_);
+    glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+QuadIndexBuffer::~QuadIndexBuffer()
+{
+    glDeleteBuffers(1, &EBO_);
+}
@@ -0,0 +1,49 @@
+#include "QuadMesh.h"
+#include "QuadIndexBuffer.h"
+#include "MeshData.h"
+#include "GLState.h"
+#include "GLPlatform.h"
+
+#include <stdexcept>
+
+QuadMesh::QuadMesh(const PackedQuad *quads, size_t count, const QuadIndexBuffer &quadIndices)
+    : quadCount(static_cast<unsigned int>(count))
+{
+    if (count > QuadIndexBuffer::kMaxQuads)
+        throw std::runtime_error("Quad mesh has more quads than the shared quad index buffer covers.");
+
+    glGenBuffers(1, &buffer);
+    GLState::bindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, count * sizeof(PackedQuad), quads, GL_STATIC_DRAW);
+
+    glGenTextures(1, &texture);
+    GLState::bindTexture(0, GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, buffer);
+
+    // No attributes: the VAO only records the index buffer
+    glGenVertexArrays(1, &VAO);
+    GLState::bindVertexArray(VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndices.getBufferId());
+    GLState::bindVertexArray(0);
+}
+
+QuadMesh::~QuadMesh()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteTextures(1, &texture);
+    glDeleteBuffers(1, &buffer);
+    GLState::vertexArrayDeleted(VAO);
+    GLState::textureDeleted(texture);
+    GLState::bufferDeleted(buffer);
+}
+
+void QuadMesh::bind(unsigned int textureUnit) const
+{
+    GLState::bindVertexArray(VAO);
+    GLState::bindTexture(textureUnit, GL_TEXTURE_BUFFER, texture);
+}
+
+void QuadMesh::unbind() const
+{
+    GLState::bindVertexArray(0);
+}
@@ -2,55 +2,133 @@
 #include "Camera.h"
 #include "Mesh.h"
 #include "Shader.h"
-#include "World.h"
+#include "InstanceBuffer.h"
+#include "QuadMesh.h"
 #include "glm/ext/matrix_float4x4.hpp"
 #include "glm/ext/matrix_transform.hpp"
+#include "GLPlatform.h"
+#include "GLState.h"
 
-#ifdef __APPLE__
-#include <OpenGL/gl3.h>
-#endif
-
-Renderer::Renderer(const Mesh &mesh, const Shader &shader) : meshToDraw(mesh), shaderToUse(shader)
+Renderer::Renderer(const Shader &shader) : shaderToUse(&shader)
 {
     // Renderer constructor can set up global GL state if needed
-    glEnable(GL_DEPTH_TEST);
+    GLState::setEnabled(GL_DEPTH_TEST, true);
 }
 
-void Renderer::render(const World &world, const Camera &camera, unsigned int textureId)
+void Renderer::clearFrame()
 {
-    // Clear buffers
-    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    GpuTimer &timer = passTimers_[static_cast<int>(GpuPass::Clear)];
+    timer.begin();
+    GLState::setClearColor(0.2f, 0.3f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    timer.end();
+}
+
+void Renderer::setModelMatrix(const Shader &shader, const glm::mat4 &model)
+{
+    shader.setMatrix4("model", model);
+    shader.setMatrix3("normalMatrix", glm::transpose(glm::inverse(glm::mat3(model))));
+}
+
+void Renderer::collectPassTimes(FrameTiming &timing)
+{
+    double total = 0.0;
+    bool complete = true;
+    for (int pass = 0; pass < static_cast<int>(GpuPass::Count); ++pass)
+    {
+        timing.gpuPassMs[pass] = passTimers_[pass].collect();
+        complete = complete && timing.gpuPassMs[pass] >= 0.0;
+        total += timing.gpuPassMs[pass];
+    }
+    timing.gpuFrameMs = complete ? total : -1.0;
+}
+
+void Renderer::beginFrame(const Camera &camera, double timeSeconds, const glm::vec4 &fogColor, const glm::vec2 &fogRange)
+{
+    FrameUniformData data;
+    data.view = camera.getViewMatrix();
+    data.projection = camera.getProjectionMatrix();
+    data.viewProjection = data.projection * data.view;
+    data.cameraPosition = glm::vec4(camera.position, 1.0f);
+    data.fogColor = fogColor;
+    data.fogRange = glm::vec4(fogRange, 0.0f, 0.0f);
+    data.time = glm::vec4(static_cast<float>(timeSeconds), 0.0f, 0.0f, 0.0f);
+    frameUniforms_.update(data);
+}
+
+void Renderer::render(unsigned int textureId, const std::vector<const Mesh *> &meshes)
+{
+    // Clear buffers
+    clearFrame();
 
     // Uncomment to enable wireframe render mode
     // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
     // Use the shader program
-    shaderToUse.use();
+    shaderToUse->use();
 
-    // Set view and projection matrices (these are usually per-frame, not per-object)
-    glm::mat4 view = camera.getViewMatrix();
-    glm::mat4 projection = camera.getProjectionMatrix();
-    shaderToUse.setMatrix4("view", view);
-    shaderToUse.setMatrix4("projection", projection);
+    // View and projection come from the frame uniform block (beginFrame)
 
-    // Bind the mesh (can be done once if all objects use the same mesh)
-    meshToDraw.bind();
+    // Chunk meshes are built in world space, so they all share the identity model matrix.
+    // The IDENTITY_MODEL variant of the shader drops the transform altogether.
+    if (!shaderToUse->hasDefine("IDENTITY_MODEL"))
+        setModelMatrix(*shaderToUse, glm::mat4(1.0f));
 
-    // Calculate the model matrix for this specific block
-    glm::mat4 model = glm::mat4(1.0f);
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, textureId);
 
-    // Pass the model matrix to the shader
-    shaderToUse.setMatrix4("model", model);
+    shaderToUse->setInt("textureSampler", 0);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+    GpuTimer &timer = passTimers_[static_cast<int>(GpuPass::World)];
+    timer.begin();
+    for (const Mesh *mesh : meshes)
+    {
+        // Draw the mesh using its VAO and the active shader
+        mesh->bind();
+        glDrawElements(GL_TRIANGLES, mesh->indexCount, mesh->indexType, 0);
+    }
+    timer.end();
+    // Program, VAO and texture stay bound: GLState skips rebinding them next frame
+}
 
-    shaderToUse.setInt("textureSampler", 0);
+void Renderer::renderQuads(const Shader &quadShader, unsigned int textureId, const std::vector<const QuadMesh *> &meshes)
+{
+    clearFrame();
 
-    // Draw the mesh using the bound VAO and active shader
-    glDrawElements(GL_TRIANGLES, meshToDraw.indexCount, GL_UNSIGNED_INT, 0);
+    quadShader.use();
+
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, textureId);
+    quadShader.setInt("textureSampler", 0);
+    quadShader.setInt("quads", 1); // Each mesh binds its quad records to unit 1
+
+    GpuTimer &timer = passTimers_[static_cast<int>(GpuPass::World)];
+    timer.begin();
+    for (const QuadMesh *mesh : meshes)
+    {
+        mesh->bind(1);
+        glDrawElements(GL_TRIANGLES, mesh->quadCount * 6, GL_UNSIGNED_SHORT, 0);
+    }
+    timer.end();
+}
 
-    meshToDraw.unbind(); // Unbind mesh after drawing
-    glUseProgram(0);     // Unbind shader after drawing
-}
\ No newline at end of file
+void Renderer::renderInstanced(const Mesh &mesh, const InstanceBuffer &instances, const Shader &shader, unsigned int textureId)
+{
+    GpuTimer &timer = passTimers_[static_cast<int>(GpuPass::Entities)];
+    if (instances.count == 0)
+    {
+        timer.begin(); // Empty measurement keeps this pass in step with the others
+        timer.end();
+        return;
+    }
+
+    timer.begin();
+    shader.use();
+
+    mesh.bind();
+
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, textureId);
+    shader.setInt("textureSampler", 0);
+
+    // One draw for all instances; the model matrix and layer come from the instance buffer
+    glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, mesh.indexType, 0, static_cast<int>(instances.count));
+    timer.end();
+}
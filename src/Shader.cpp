@@ -5,13 +5,16 @@
 #include <iostream>
 #include <ostream>
 #include <cstddef>
+#include <cstring>
+#include <filesystem>
 #include "glm/ext/matrix_float4x4.hpp"
 #include "glm/gtc/type_ptr.hpp"
 #include "glm/ext/vector_float3.hpp"
-
-#ifdef __APPLE__
-#include <OpenGL/gl3.h>
-#endif
+#include "GLPlatform.h"
+#include "GLState.h"
+#include "FrameUniforms.h"
+#include "ProgramCache.h"
+#include "ShaderPreprocessor.h"
 
 std::string readShaderFile(const std::string &filePath)
 {
@@ -41,37 +44,87 @@ std::string readShaderFile(const std::string &filePath)
     return shaderCode;
 }
 
-unsigned int compileShader(unsigned int type, const char *source)
+namespace
 {
-    unsigned int id = glCreateShader(type); // Create a shader object (ID)
-    glShaderSource(id, 1, &source, NULL);   // Set the shader source code
-    glCompileShader(id);                    // Compile the shader
+    // Whether the driver compiles and links on its own threads and can be asked if it is done
+    bool parallelCompileSupported()
+    {
+        static const bool supported = []
+        {
+            GLint extensionCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+            for (GLint i = 0; i < extensionCount; ++i)
+            {
+                const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+                if (name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 || std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0))
+                    return true;
+            }
+            return false;
+        }();
+        return supported;
+    }
 
-    // Check for compilation errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(id, GL_COMPILE_STATUS, &success);
-    if (!success)
+    // Queues the compile; the status is only checked (and waited for) by checkCompile
+    unsigned int startCompile(unsigned int type, const char *source)
+    {
+        unsigned int id = glCreateShader(type); // Create a shader object (ID)
+        glShaderSource(id, 1, &source, NULL);   // Set the shader source code
+        glCompileShader(id);                    // Compile the shader
+        return id;
+    }
+
+    // Prints the info log and returns false if the shader did not compile. 'files' (from
+    // preprocessShader) names the source strings the log's line numbers refer to.
+    bool checkCompile(unsigned int id, unsigned int type, const std::vector<std::string> &files = {})
+    {
+        // Check for compilation errors
+        int success;
+        char infoLog[512];
+        glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            if (type == GL_VERTEX_SHADER)
+                std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n";
+            else if (type == GL_FRAGMENT_SHADER)
+                std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n";
+            else
+                std::cerr << "ERROR::SHADER::UNKNOWN_TYPE::COMPILATION_FAILED\n";
+            glGetShaderInfoLog(id, 512, NULL, infoLog);
+            std::cerr << infoLog << std::endl;
+            if (files.size() > 1)
+            {
+                std::cerr << "Source strings:";
+                for (size_t i = 0; i < files.size(); ++i)
+                    std::cerr << (i == 0 ? " " : ", ") << i << " = " << files[i];
+                std::cerr << std::endl;
+            }
+            return false;
+        }
+        return true;
+    }
+}
+
+unsigned int compileShader(unsigned int type, const char *source)
+{
+    unsigned int id = startCompile(type, source);
+    if (!checkCompile(id, type))
     {
-        if (type == GL_VERTEX_SHADER)
-            std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n";
-        else if (type == GL_FRAGMENT_SHADER)
-            std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n";
-        else
-            std::cerr << "ERROR::SHADER::UNKNOWN_TYPE::COMPILATION_FAILED\n";
-        glGetShaderInfoLog(id, 512, NULL, infoLog);
-        std::cerr << infoLog << std::endl;
         glDeleteShader(id); // Delete the shader if compilation failed
         return 0;
     }
     return id; // Return the shader ID
 }
 
-Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath)
+Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath, const std::vector<std::string> &defines)
+    : vertexPath_(vertexPath), fragmentPath_(fragmentPath), defines_(defines)
 {
-    // Read shader files
-    std::string vertexCode = readShaderFile(vertexPath);
-    std::string fragmentCode = readShaderFile(fragmentPath);
+    // Read shader files, with their includes and this variant's defines
+    PreprocessedShader vertexShader = preprocessShader(vertexPath, defines_);
+    PreprocessedShader fragmentShader = preprocessShader(fragmentPath, defines_);
+    const std::string &vertexCode = vertexShader.source;
+    const std::string &fragmentCode = fragmentShader.source;
+    vertexFiles_ = vertexShader.files;
+    fragmentFiles_ = fragmentShader.files;
 
     if (vertexCode.empty() || fragmentCode.empty())
     {
@@ -79,14 +132,26 @@ Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath)
         return;
     }
 
+    // A program linked on an earlier run skips compiling and linking entirely
+    const uint64_t cacheKey = ProgramCache::makeKey(vertexCode, fragmentCode);
+    ID = ProgramCache::load(cacheKey);
+    if (ID != 0)
+    {
+        finishLink();
+        return;
+    }
+
     const char *vShaderCode = vertexCode.c_str();
     const char *fShaderCode = fragmentCode.c_str();
 
     // Compile shaders
-    unsigned int vertex = compileShader(GL_VERTEX_SHADER, vShaderCode);
-    unsigned int fragment = compileShader(GL_FRAGMENT_SHADER, fShaderCode);
+    unsigned int vertex = startCompile(GL_VERTEX_SHADER, vShaderCode);
+    unsigned int fragment = startCompile(GL_FRAGMENT_SHADER, fShaderCode);
 
-    if (vertex == 0 || fragment == 0)
+    // Both are checked so a failing variant reports every error at once
+    bool vertexCompiled = checkCompile(vertex, GL_VERTEX_SHADER, vertexFiles_);
+    bool fragmentCompiled = checkCompile(fragment, GL_FRAGMENT_SHADER, fragmentFiles_);
+    if (!vertexCompiled || !fragmentCompiled)
     {
         // compilation failed, helper prints error
         glDeleteShader(vertex);   // Safe to call on 0
@@ -99,6 +164,7 @@ Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath)
     ID = glCreateProgram();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
+    glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE); // For ProgramCache::store
     glLinkProgram(ID);
 
     // Check for linking errors
@@ -113,23 +179,160 @@ Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath)
         glDeleteProgram(ID);
         ID = 0; // Indicate failure
     }
+    else
+    {
+        ProgramCache::store(cacheKey, ID);
+        finishLink();
+    }
 
     // Delete the shaders as they're linked into our program now and no longer needed
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 }
 
+void Shader::finishLink()
+{
+    // Programs that read the per-frame block all get it from the same binding point.
+    // Block bindings are not part of a program binary, so this runs for cached programs too.
+    unsigned int frameBlock = glGetUniformBlockIndex(ID, FrameUniforms::kBlockName);
+    if (frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID, frameBlock, FrameUniforms::kBindingPoint);
+}
+
 Shader::~Shader()
 {
+    discardPending();
     if (ID != 0)
     { // Only delete if the program was successfully created
         glDeleteProgram(ID);
+        GLState::programDeleted(ID);
     }
 }
 
 void Shader::use() const
 {
-    glUseProgram(ID);
+    GLState::useProgram(ID);
+}
+
+bool Shader::dependsOn(const std::string &fileName) const
+{
+    for (const std::vector<std::string> *files : {&vertexFiles_, &fragmentFiles_})
+    {
+        for (const std::string &file : *files)
+        {
+            if (std::filesystem::path(file).filename() == fileName)
+                return true;
+        }
+    }
+    // Not read (yet) because the file was missing: any change may fix that
+    return vertexFiles_.empty() || fragmentFiles_.empty();
+}
+
+bool Shader::hasDefine(const std::string &name) const
+{
+    for (const std::string &define : defines_)
+    {
+        if (define.compare(0, define.find(' '), name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void Shader::beginReload()
+{
+    PreprocessedShader vertexShader = preprocessShader(vertexPath_, defines_);
+    PreprocessedShader fragmentShader = preprocessShader(fragmentPath_, defines_);
+    if (vertexShader.source.empty() || fragmentShader.source.empty())
+        return; // Mid-save or deleted; the next change event tries again
+    const std::string &vertexCode = vertexShader.source;
+    const std::string &fragmentCode = fragmentShader.source;
+    // An edit may have added or removed includes
+    vertexFiles_ = vertexShader.files;
+    fragmentFiles_ = fragmentShader.files;
+
+    // A newer edit replaces a reload that has not finished yet
+    discardPending();
+
+    // Reverting an edit finds the earlier program in the cache
+    pending_.cacheKey = ProgramCache::makeKey(vertexCode, fragmentCode);
+    pending_.program = ProgramCache::load(pending_.cacheKey);
+    if (pending_.program != 0)
+        return;
+
+    // Nothing below waits for the driver; applyReload() checks the results
+    pending_.vertex = startCompile(GL_VERTEX_SHADER, vertexCode.c_str());
+    pending_.fragment = startCompile(GL_FRAGMENT_SHADER, fragmentCode.c_str());
+    pending_.program = glCreateProgram();
+    glAttachShader(pending_.program, pending_.vertex);
+    glAttachShader(pending_.program, pending_.fragment);
+    glProgramParameteri(pending_.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(pending_.program);
+}
+
+bool Shader::applyReload()
+{
+    if (pending_.program == 0)
+        return false;
+
+    // Any status query would block until the driver's compiler threads are done, so wait for
+    // the completion flag first. Without the extension the queries below simply wait here.
+    if (pending_.vertex != 0 && parallelCompileSupported())
+    {
+        GLint complete = GL_FALSE;
+        glGetProgramiv(pending_.program, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete)
+            return false;
+    }
+
+    if (pending_.vertex != 0)
+    {
+        bool compiled = checkCompile(pending_.vertex, GL_VERTEX_SHADER, vertexFiles_);
+        compiled = checkCompile(pending_.fragment, GL_FRAGMENT_SHADER, fragmentFiles_) && compiled;
+        int linked = GL_FALSE;
+        if (compiled)
+        {
+            glGetProgramiv(pending_.program, GL_LINK_STATUS, &linked);
+            if (!linked)
+            {
+                char infoLog[512];
+                std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n";
+                glGetProgramInfoLog(pending_.program, 512, NULL, infoLog);
+                std::cerr << infoLog << std::endl;
+            }
+        }
+        if (!compiled || !linked)
+        {
+            std::cerr << "Reloading " << vertexPath_ << " + " << fragmentPath_ << " failed, keeping the previous program." << std::endl;
+            discardPending();
+            return false;
+        }
+        ProgramCache::store(pending_.cacheKey, pending_.program);
+        glDeleteShader(pending_.vertex);
+        glDeleteShader(pending_.fragment);
+    }
+
+    if (ID != 0)
+    {
+        glDeleteProgram(ID);
+        GLState::programDeleted(ID);
+    }
+    ID = pending_.program;
+    pending_ = PendingProgram();
+    finishLink();
+    std::cout << "Reloaded " << vertexPath_ << " + " << fragmentPath_ << "." << std::endl;
+    return true;
+}
+
+void Shader::discardPending()
+{
+    // Deleting shaders and programs never waits for a compile in progress
+    if (pending_.program != 0)
+        glDeleteProgram(pending_.program);
+    if (pending_.vertex != 0)
+        glDeleteShader(pending_.vertex);
+    if (pending_.fragment != 0)
+        glDeleteShader(pending_.fragment);
+    pending_ = PendingProgram();
 }
 
 void Shader::setMatrix4(const std::string &name, const glm::mat4 &matrix) const
@@ -146,6 +349,11 @@ void Shader::setMatrix4(const std::string &name, const glm::mat4 &matrix) const
     glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
+void Shader::setMatrix3(const std::string &name, const glm::mat3 &matrix) const
+{
+    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
 // Implementations for other uniform setters (copied from common practice)
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
 {
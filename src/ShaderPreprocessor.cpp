@@ -0,0 +1,89 @@
+#include "ShaderPreprocessor.h"
+#include "Shader.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    // Parses '#include "name"' (spaces allowed around the tokens); false for any other line
+    bool parseInclude(const std::string &line, std::string &name)
+    {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line.compare(pos, 1, "#") != 0)
+            return false;
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+            return false;
+        size_t open = line.find('"', pos + 7);
+        size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos)
+            return false;
+        name = line.substr(open + 1, close - open - 1);
+        return true;
+    }
+
+    bool startsWithVersion(const std::string &line)
+    {
+        size_t pos = line.find_first_not_of(" \t");
+        return pos != std::string::npos && line.compare(pos, 8, "#version") == 0;
+    }
+
+    // Appends 'path' to 'out' with its includes expanded. False if any file could not be read.
+    bool appendFile(const std::string &path, const std::vector<std::string> &defines, PreprocessedShader &result, std::string &out)
+    {
+        std::string code = readShaderFile(path); // Prints its own error
+        if (code.empty())
+            return false;
+
+        const int sourceNumber = static_cast<int>(result.files.size());
+        result.files.push_back(path);
+        const bool isMainFile = sourceNumber == 0;
+
+        std::istringstream lines(code);
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(lines, line))
+        {
+            ++lineNumber;
+            std::string include;
+            if (isMainFile && startsWithVersion(line))
+            {
+                out += line + "\n";
+                for (const std::string &define : defines)
+                    out += "#define " + define + "\n";
+                out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n";
+            }
+            else if (parseInclude(line, include))
+            {
+                std::string includePath = (std::filesystem::path(path).parent_path() / include).lexically_normal().generic_string();
+                if (std::find(result.files.begin(), result.files.end(), includePath) == result.files.end())
+                {
+                    out += "#line 1 " + std::to_string(result.files.size()) + "\n";
+                    if (!appendFile(includePath, defines, result, out))
+                    {
+                        std::cerr << "  (included from " << path << ":" << lineNumber << ")" << std::endl;
+                        return false;
+                    }
+                }
+                out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n";
+            }
+            else
+            {
+                out += line + "\n";
+            }
+        }
+        return true;
+    }
+}
+
+PreprocessedShader preprocessShader(const std::string &path, const std::vector<std::string> &defines)
+{
+    PreprocessedShader result;
+    std::string source;
+    if (appendFile(path, defines, result, source))
+        result.source = std::move(source);
+    return result;
+}
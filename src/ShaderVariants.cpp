@@ -0,0 +1,40 @@
+#include "ShaderVariants.h"
+#include "Shader.h"
+
+#include <algorithm>
+
+ShaderVariants::ShaderVariants() = default;
+ShaderVariants::~ShaderVariants() = default;
+
+Shader &ShaderVariants::get(const std::string &vertexPath, const std::string &fragmentPath, std::vector<std::string> defines)
+{
+    std::sort(defines.begin(), defines.end());
+    std::string key = vertexPath + '|' + fragmentPath;
+    for (const std::string &define : defines)
+        key += '|' + define;
+
+    std::unique_ptr<Shader> &program = programs_[key];
+    if (!program)
+        program = std::make_unique<Shader>(vertexPath, fragmentPath, defines);
+    return *program;
+}
+
+void ShaderVariants::reloadChanged(const std::vector<std::string> &changedFiles)
+{
+    for (const std::string &file : changedFiles)
+    {
+        for (auto &entry : programs_)
+        {
+            if (entry.second->dependsOn(file))
+                entry.second->beginReload();
+        }
+    }
+
+    for (auto &entry : programs_)
+        entry.second->applyReload();
+}
+
+void ShaderVariants::clear()
+{
+    programs_.clear();
+}
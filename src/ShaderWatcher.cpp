@@ -0,0 +1,102 @@
+#include "ShaderWatcher.h"
+
+#include <algorithm>
+#include <iostream>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ShaderWatcher::ShaderWatcher(const std::string &directory)
+    : directory_(directory), lastScan_(std::chrono::steady_clock::now())
+{
+#ifdef __linux__
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    // Editors either rewrite the file in place (close after write) or write a temporary file
+    // and rename it over the original (moved to), so both count as a change
+    if (inotifyFd_ >= 0 && inotify_add_watch(inotifyFd_, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+#endif
+    if (inotifyFd_ < 0)
+        scan(nullptr); // Baseline modification times
+    std::cout << "Watching " << directory_ << " for shader changes"
+              << (inotifyFd_ >= 0 ? " (inotify)." : " (polling modification times).") << std::endl;
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+#ifdef __linux__
+    if (inotifyFd_ >= 0)
+        close(inotifyFd_);
+#endif
+}
+
+std::vector<std::string> ShaderWatcher::poll()
+{
+    std::vector<std::string> changed;
+#ifdef __linux__
+    if (inotifyFd_ >= 0)
+    {
+        alignas(struct inotify_event) char buffer[4096];
+        for (;;)
+        {
+            ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+            if (length <= 0)
+                break; // EAGAIN: nothing (more) queued
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+                if (event->len > 0)
+                {
+                    std::string name(event->name);
+                    if (std::find(changed.begin(), changed.end(), name) == changed.end())
+                        changed.push_back(name);
+                }
+                offset += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        return changed;
+    }
+#endif
+
+    // A stat of every shader each frame is cheap but pointless; edits are not that fast
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastScan_ >= std::chrono::milliseconds(250))
+    {
+        lastScan_ = now;
+        scan(&changed);
+    }
+    return changed;
+}
+
+void ShaderWatcher::scan(std::vector<std::string> *changed)
+{
+    std::error_code error;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory_, error))
+    {
+        if (!entry.is_regular_file(error))
+            continue;
+        std::filesystem::file_time_type writeTime = entry.last_write_time(error);
+        if (error)
+            continue;
+        std::string name = entry.path().filename().string();
+        auto it = writeTimes_.find(name);
+        if (it == writeTimes_.end())
+        {
+            writeTimes_.emplace(name, writeTime);
+            if (changed)
+                changed->push_back(name); // New file (e.g. recreated after a delete)
+        }
+        else if (it->second != writeTime)
+        {
+            it->second = writeTime;
+            if (changed)
+                changed->push_back(name);
+        }
+    }
+}
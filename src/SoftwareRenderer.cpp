@@ -0,0 +1,465 @@
+#include "SoftwareRenderer.h"
+#include "Camera.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOFTWARE_RENDERER_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SOFTWARE_RENDERER_NEON 1
+#endif
+
+namespace
+{
+    constexpr int kTileSize = 64;
+    // Vertex positions snap to 1/256 pixel, like the 8 subpixel bits of GL rasterizers
+    constexpr float kSubpixelSteps = 256.0f;
+    // Same clear color as Renderer::render
+    const unsigned char kClearColor[4] = {51, 77, 77, 255};
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // --- 4-wide float vectors for evaluating 4 horizontally adjacent pixels at once ---
+    // Only the handful of operations the rasterizer needs; comparisons return a 4-bit lane mask.
+#if defined(SOFTWARE_RENDERER_SSE2)
+    struct Float4
+    {
+        __m128 v;
+    };
+    inline Float4 splat(float x) { return {_mm_set1_ps(x)}; }
+    inline Float4 load(const float *p) { return {_mm_loadu_ps(p)}; }
+    inline void store(float *p, Float4 a) { _mm_storeu_ps(p, a.v); }
+    inline Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    inline Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    inline Float4 operator/(Float4 a, Float4 b) { return {_mm_div_ps(a.v, b.v)}; }
+    inline int greaterEqualMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmpge_ps(a.v, b.v)); }
+    inline int greaterMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmpgt_ps(a.v, b.v)); }
+    inline int lessMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)); }
+    inline Float4 laneOffsets() { return {_mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f)}; }
+#elif defined(SOFTWARE_RENDERER_NEON)
+    struct Float4
+    {
+        float32x4_t v;
+    };
+    inline int laneBits(uint32x4_t m)
+    {
+        const uint32_t bitValues[4] = {1, 2, 4, 8};
+        return static_cast<int>(vaddvq_u32(vandq_u32(m, vld1q_u32(bitValues))));
+    }
+    inline Float4 splat(float x) { return {vdupq_n_f32(x)}; }
+    inline Float4 load(const float *p) { return {vld1q_f32(p)}; }
+    inline void store(float *p, Float4 a) { vst1q_f32(p, a.v); }
+    inline Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+    inline Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+    inline Float4 operator/(Float4 a, Float4 b) { return {vdivq_f32(a.v, b.v)}; }
+    inline int greaterEqualMask(Float4 a, Float4 b) { return laneBits(vcgeq_f32(a.v, b.v)); }
+    inline int greaterMask(Float4 a, Float4 b) { return laneBits(vcgtq_f32(a.v, b.v)); }
+    inline int lessMask(Float4 a, Float4 b) { return laneBits(vcltq_f32(a.v, b.v)); }
+    inline Float4 laneOffsets()
+    {
+        const float offsets[4] = {0.5f, 1.5f, 2.5f, 3.5f};
+        return {vld1q_f32(offsets)};
+    }
+#else
+    struct Float4
+    {
+        float v[4];
+    };
+    inline Float4 splat(float x) { return {{x, x, x, x}}; }
+    inline Float4 load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+    inline void store(float *p, Float4 a) { std::memcpy(p, a.v, sizeof(a.v)); }
+    inline Float4 operator+(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+    inline Float4 operator*(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+    inline Float4 operator/(Float4 a, Float4 b) { return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}}; }
+    inline int greaterEqualMask(Float4 a, Float4 b)
+    {
+        return (a.v[0] >= b.v[0]) | (a.v[1] >= b.v[1]) << 1 | (a.v[2] >= b.v[2]) << 2 | (a.v[3] >= b.v[3]) << 3;
+    }
+    inline int greaterMask(Float4 a, Float4 b)
+    {
+        return (a.v[0] > b.v[0]) | (a.v[1] > b.v[1]) << 1 | (a.v[2] > b.v[2]) << 2 | (a.v[3] > b.v[3]) << 3;
+    }
+    inline int lessMask(Float4 a, Float4 b)
+    {
+        return (a.v[0] < b.v[0]) | (a.v[1] < b.v[1]) << 1 | (a.v[2] < b.v[2]) << 2 | (a.v[3] < b.v[3]) << 3;
+    }
+    inline Float4 laneOffsets() { return {{0.5f, 1.5f, 2.5f, 3.5f}}; }
+#endif
+
+    // Vertex of a triangle being clipped against the near and far planes
+    struct ClipVertex
+    {
+        glm::vec4 position;
+        glm::vec2 uv;
+    };
+
+    // Sutherland-Hodgman against one plane; 'distance' is >= 0 on the kept side
+    template <typename Distance>
+    int clipPolygon(const ClipVertex *in, int count, ClipVertex *out, Distance distance)
+    {
+        int outCount = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const ClipVertex &a = in[i];
+            const ClipVertex &b = in[(i + 1) % count];
+            float da = distance(a.position);
+            float db = distance(b.position);
+            if (da >= 0.0f)
+                out[outCount++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f))
+            {
+                float t = da / (da - db);
+                out[outCount++] = ClipVertex{a.position + (b.position - a.position) * t, a.uv + (b.uv - a.uv) * t};
+            }
+        }
+        return outCount;
+    }
+
+    // floor() to int without the libm call std::floor compiles to on baseline x86-64
+    int fastFloor(float value)
+    {
+        int truncated = static_cast<int>(value);
+        return truncated - (value < static_cast<float>(truncated));
+    }
+
+    // GL_REPEAT texel index from a coordinate already scaled to texels; power-of-two sizes
+    // (the common case) avoid the integer division
+    int wrapTexel(float texelCoordinate, int size, int mask)
+    {
+        int i = fastFloor(texelCoordinate);
+        if (mask >= 0)
+            return i & mask;
+        i %= size;
+        return i < 0 ? i + size : i;
+    }
+
+    // The alpha test of shader.fs (discard below 0.5); texels are RGBA bytes in memory
+    bool passesAlphaTest(uint32_t texel)
+    {
+        unsigned char rgba[4];
+        std::memcpy(rgba, &texel, sizeof(rgba));
+        return rgba[3] >= 128;
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(JobSystem &jobs)
+    : jobs_(jobs)
+{
+}
+
+unsigned int SoftwareRenderer::getThreadCount() const
+{
+    return jobs_.getThreadCount();
+}
+
+void SoftwareRenderer::beginFrame(int width, int height, const Camera &camera)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    if (width != width_ || height != height_)
+    {
+        width_ = width;
+        height_ = height;
+        depthStride_ = (width + 3) & ~3;
+        tilesX_ = (width + kTileSize - 1) / kTileSize;
+        tilesY_ = (height + kTileSize - 1) / kTileSize;
+        color_.assign(static_cast<size_t>(width) * height, 0);
+        depth_.assign(static_cast<size_t>(depthStride_) * height, 1.0f);
+        bins_.assign(static_cast<size_t>(tilesX_) * tilesY_, std::vector<uint32_t>());
+    }
+
+    uint32_t clear;
+    std::memcpy(&clear, kClearColor, sizeof(clear));
+    std::fill(color_.begin(), color_.end(), clear);
+    std::fill(depth_.begin(), depth_.end(), 1.0f);
+
+    triangles_.clear();
+    for (std::vector<uint32_t> &bin : bins_)
+        bin.clear();
+
+    viewProjection_ = camera.getProjectionMatrix() * camera.getViewMatrix();
+    frameSetupMs_ = millisecondsSince(start);
+}
+
+void SoftwareRenderer::drawMeshes(const std::vector<const MeshData *> &meshes)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (const MeshData *mesh : meshes)
+        submitMesh(*mesh, viewProjection_, -1.0f);
+    frameSetupMs_ += millisecondsSince(start);
+}
+
+void SoftwareRenderer::drawInstances(const MeshData &mesh, const std::vector<InstanceData> &instances)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (const InstanceData &instance : instances)
+        submitMesh(mesh, viewProjection_ * instance.model, instance.layer);
+    frameSetupMs_ += millisecondsSince(start);
+}
+
+void SoftwareRenderer::endFrame()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // One job per tile
+    jobs_.parallelFor(static_cast<size_t>(tilesX_) * tilesY_, 1, [this](size_t begin, size_t end)
+                      {
+                          for (size_t tile = begin; tile < end; ++tile)
+                              rasterizeTile(static_cast<int>(tile));
+                      });
+
+    stats_.frames++;
+    stats_.triangles += triangles_.size();
+    stats_.setupMs += frameSetupMs_;
+    stats_.rasterMs += millisecondsSince(start);
+    stats_.megapixels += static_cast<double>(width_) * height_ / 1.0e6;
+}
+
+void SoftwareRenderer::reportStats(std::ostream &out) const
+{
+    if (stats_.frames == 0)
+        return;
+    double frames = static_cast<double>(stats_.frames);
+    double totalMs = stats_.setupMs + stats_.rasterMs;
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2)
+        << "  Software rasterizer (" << getThreadCount() << " threads): "
+        << totalMs / frames << "ms/frame (setup " << stats_.setupMs / frames
+        << ", raster " << stats_.rasterMs / frames << "), "
+        << totalMs / stats_.megapixels << "ms per megapixel, "
+        << stats_.triangles / stats_.frames << " triangles/frame" << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void SoftwareRenderer::submitMesh(const MeshData &mesh, const glm::mat4 &mvp, float layerOverride)
+{
+    const size_t indexCount = mesh.indices.size() - mesh.indices.size() % 3;
+    for (size_t i = 0; i < indexCount; i += 3)
+    {
+        ClipVertex polygon[5];
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int index = mesh.indices[i + k];
+            polygon[k].position = mvp * glm::vec4(mesh.vertices[index], 1.0f);
+            polygon[k].uv = mesh.texCoords[index];
+        }
+        // Flat layer comes from the last (provoking) vertex, as in GL
+        int layer = static_cast<int>(std::floor((layerOverride >= 0.0f ? layerOverride : mesh.layerIndices[mesh.indices[i + 2]]) + 0.5f));
+
+        // Clip against the near (z >= -w) and far (z <= w) planes only; the other four
+        // are handled by clamping each triangle's bounds to the framebuffer
+        bool inside = true;
+        for (int k = 0; k < 3; ++k)
+        {
+            const glm::vec4 &p = polygon[k].position;
+            inside = inside && p.z >= -p.w && p.z <= p.w;
+        }
+        int count = 3;
+        if (!inside)
+        {
+            ClipVertex clipped[5];
+            count = clipPolygon(polygon, count, clipped, [](const glm::vec4 &p)
+                                { return p.z + p.w; });
+            count = clipPolygon(clipped, count, polygon, [](const glm::vec4 &p)
+                                { return p.w - p.z; });
+        }
+
+        for (int k = 1; k + 1 < count; ++k)
+        {
+            const glm::vec4 clip[3] = {polygon[0].position, polygon[k].position, polygon[k + 1].position};
+            const glm::vec2 uv[3] = {polygon[0].uv, polygon[k].uv, polygon[k + 1].uv};
+            setupTriangle(clip, uv, layer);
+        }
+    }
+}
+
+void SoftwareRenderer::setupTriangle(const glm::vec4 clip[3], const glm::vec2 uv[3], int layer)
+{
+    float sx[3], sy[3], z[3], invW[3];
+    for (int k = 0; k < 3; ++k)
+    {
+        invW[k] = 1.0f / clip[k].w;
+        float ndcX = clip[k].x * invW[k];
+        float ndcY = clip[k].y * invW[k];
+        sx[k] = std::round((ndcX * 0.5f + 0.5f) * static_cast<float>(width_) * kSubpixelSteps) / kSubpixelSteps;
+        sy[k] = std::round((ndcY * 0.5f + 0.5f) * static_cast<float>(height_) * kSubpixelSteps) / kSubpixelSteps;
+        z[k] = clip[k].z * invW[k] * 0.5f + 0.5f;
+    }
+
+    // Twice the signed area; counter-clockwise (front facing) triangles are positive
+    double area2 = (static_cast<double>(sx[1]) - sx[0]) * (static_cast<double>(sy[2]) - sy[0]) -
+                   (static_cast<double>(sx[2]) - sx[0]) * (static_cast<double>(sy[1]) - sy[0]);
+    if (!(area2 > 0.0))
+        return; // Back facing or degenerate (GL_CULL_FACE with GL_BACK)
+
+    Triangle t;
+    t.minX = std::max(0, static_cast<int>(std::ceil(std::min({sx[0], sx[1], sx[2]}) - 0.5f)));
+    t.maxX = std::min(width_ - 1, static_cast<int>(std::floor(std::max({sx[0], sx[1], sx[2]}) - 0.5f)));
+    t.minY = std::max(0, static_cast<int>(std::ceil(std::min({sy[0], sy[1], sy[2]}) - 0.5f)));
+    t.maxY = std::min(height_ - 1, static_cast<int>(std::floor(std::max({sy[0], sy[1], sy[2]}) - 0.5f)));
+    if (t.minX > t.maxX || t.minY > t.maxY)
+        return;
+
+    // Edge k is opposite vertex k. Computed in float from the snapped positions so the
+    // edge shared by two triangles evaluates to exactly opposite values in both: together
+    // with the fill rule every pixel on it is drawn once, with no cracks or overdraw.
+    for (int k = 0; k < 3; ++k)
+    {
+        int a = (k + 1) % 3;
+        int b = (k + 2) % 3;
+        t.edgeA[k] = sy[a] - sy[b];
+        t.edgeB[k] = sx[b] - sx[a];
+        t.edgeC[k] = sx[a] * sy[b] - sy[a] * sx[b];
+        t.edgeTopLeft[k] = t.edgeA[k] > 0.0f || (t.edgeA[k] == 0.0f && t.edgeB[k] < 0.0f);
+    }
+
+    // Plane equations: value = sum(edge_k(p) * value_k) / area2
+    auto plane = [&](const double values[3], float out[3])
+    {
+        double dx = 0.0, dy = 0.0, c = 0.0;
+        for (int k = 0; k < 3; ++k)
+        {
+            dx += t.edgeA[k] * values[k];
+            dy += t.edgeB[k] * values[k];
+            c += t.edgeC[k] * values[k];
+        }
+        out[0] = static_cast<float>(dx / area2);
+        out[1] = static_cast<float>(dy / area2);
+        out[2] = static_cast<float>(c / area2);
+    };
+    const double zValues[3] = {z[0], z[1], z[2]};
+    const double invWValues[3] = {invW[0], invW[1], invW[2]};
+    const double uValues[3] = {uv[0].x * invW[0], uv[1].x * invW[1], uv[2].x * invW[2]};
+    const double vValues[3] = {uv[0].y * invW[0], uv[1].y * invW[1], uv[2].y * invW[2]};
+    plane(zValues, t.z);
+    plane(invWValues, t.invW);
+    plane(uValues, t.uOverW);
+    plane(vValues, t.vOverW);
+
+    int levelCount = static_cast<int>(texture_.levels.size());
+    t.layer = std::max(0, std::min(layer, texture_.layers - 1));
+    t.mipLevel = 0;
+    if (levelCount > 1)
+    {
+        // Texels covered per pixel, taken over the whole triangle: lambda = log2(sqrt(texel area / pixel area))
+        const SoftwareTexture::Level &base = texture_.levels[0];
+        double texelArea2 = std::fabs((static_cast<double>(uv[1].x) - uv[0].x) * (static_cast<double>(uv[2].y) - uv[0].y) -
+                                      (static_cast<double>(uv[2].x) - uv[0].x) * (static_cast<double>(uv[1].y) - uv[0].y)) *
+                            base.width * base.height;
+        double lambda = 0.5 * std::log2(texelArea2 / area2);
+        if (lambda > 0.0) // Minified: nearest mip level, as GL_NEAREST_MIPMAP_NEAREST
+            t.mipLevel = std::min(levelCount - 1, static_cast<int>(std::ceil(lambda + 0.5)) - 1);
+    }
+
+    uint32_t index = static_cast<uint32_t>(triangles_.size());
+    triangles_.push_back(t);
+
+    for (int ty = t.minY / kTileSize; ty <= t.maxY / kTileSize; ++ty)
+    {
+        for (int tx = t.minX / kTileSize; tx <= t.maxX / kTileSize; ++tx)
+            bins_[ty * tilesX_ + tx].push_back(index);
+    }
+}
+
+void SoftwareRenderer::rasterizeTile(int tile)
+{
+    const std::vector<uint32_t> &bin = bins_[tile];
+    if (bin.empty() || texture_.levels.empty())
+        return;
+
+    const int tileX0 = (tile % tilesX_) * kTileSize;
+    const int tileY0 = (tile / tilesX_) * kTileSize;
+    const int tileX1 = std::min(tileX0 + kTileSize, width_) - 1;
+    const int tileY1 = std::min(tileY0 + kTileSize, height_) - 1;
+    const Float4 zero = splat(0.0f);
+
+    for (uint32_t index : bin)
+    {
+        const Triangle &t = triangles_[index];
+        const int minX = std::max(t.minX, tileX0);
+        const int maxX = std::min(t.maxX, tileX1);
+        const int minY = std::max(t.minY, tileY0);
+        const int maxY = std::min(t.maxY, tileY1);
+
+        const SoftwareTexture::Level &level = texture_.levels[t.mipLevel];
+        const uint32_t *texels = level.texels.data() + static_cast<size_t>(t.layer) * level.width * level.height;
+        const int maskX = (level.width & (level.width - 1)) == 0 ? level.width - 1 : -1;
+        const int maskY = (level.height & (level.height - 1)) == 0 ? level.height - 1 : -1;
+
+        const Float4 a0 = splat(t.edgeA[0]), a1 = splat(t.edgeA[1]), a2 = splat(t.edgeA[2]);
+        const Float4 zDx = splat(t.z[0]);
+        const Float4 invWDx = splat(t.invW[0]);
+        const Float4 uDx = splat(t.uOverW[0] * static_cast<float>(level.width));
+        const Float4 vDx = splat(t.vOverW[0] * static_cast<float>(level.height));
+
+        for (int y = minY; y <= maxY; ++y)
+        {
+            const float py = static_cast<float>(y) + 0.5f;
+            // Row constants, evaluated as A * px + (B * py + C) so shared edges stay exact
+            const Float4 row0 = splat(t.edgeB[0] * py + t.edgeC[0]);
+            const Float4 row1 = splat(t.edgeB[1] * py + t.edgeC[1]);
+            const Float4 row2 = splat(t.edgeB[2] * py + t.edgeC[2]);
+            const Float4 rowZ = splat(t.z[1] * py + t.z[2]);
+            const Float4 rowInvW = splat(t.invW[1] * py + t.invW[2]);
+            const Float4 rowU = splat((t.uOverW[1] * py + t.uOverW[2]) * static_cast<float>(level.width));
+            const Float4 rowV = splat((t.vOverW[1] * py + t.vOverW[2]) * static_cast<float>(level.height));
+            float *depthRow = depth_.data() + static_cast<size_t>(y) * depthStride_;
+            uint32_t *colorRow = color_.data() + static_cast<size_t>(y) * width_;
+
+            for (int x = minX & ~3; x <= maxX; x += 4)
+            {
+                const Float4 px = splat(static_cast<float>(x)) + laneOffsets();
+                const Float4 w0 = a0 * px + row0;
+                const Float4 w1 = a1 * px + row1;
+                const Float4 w2 = a2 * px + row2;
+
+                int mask = (t.edgeTopLeft[0] ? greaterEqualMask(w0, zero) : greaterMask(w0, zero)) &
+                           (t.edgeTopLeft[1] ? greaterEqualMask(w1, zero) : greaterMask(w1, zero)) &
+                           (t.edgeTopLeft[2] ? greaterEqualMask(w2, zero) : greaterMask(w2, zero));
+                // Lanes outside this triangle's span of the tile
+                if (x < minX)
+                    mask &= 0xF << (minX - x);
+                if (x + 3 > maxX)
+                    mask &= 0xF >> (x + 3 - maxX);
+                if (!mask)
+                    continue;
+
+                const Float4 z = zDx * px + rowZ;
+                mask &= lessMask(z, load(depthRow + x)); // GL_LESS
+                if (!mask)
+                    continue;
+
+                // Perspective-correct texel coordinates for all 4 lanes, then fetch per covered lane
+                const Float4 w = splat(1.0f) / (invWDx * px + rowInvW);
+                float zLanes[4], uLanes[4], vLanes[4];
+                store(zLanes, z);
+                store(uLanes, (uDx * px + rowU) * w);
+                store(vLanes, (vDx * px + rowV) * w);
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if (!(mask & (1 << lane)))
+                        continue;
+                    const int texelX = wrapTexel(uLanes[lane], level.width, maskX);
+                    const int texelY = wrapTexel(vLanes[lane], level.height, maskY);
+                    const uint32_t texel = texels[texelY * level.width + texelX];
+                    if (!passesAlphaTest(texel))
+                        continue; // Cut out: neither color nor depth is written
+                    depthRow[x + lane] = zLanes[lane];
+                    colorRow[x + lane] = texel;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,246 @@
+#include "TextureArrayBuilder.h"
+#include "GLPlatform.h"
+#include "GLState.h"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    // Alpha test threshold the coverage of cutout mips is preserved for
+    const float kAlphaCutoff = 0.5f;
+
+    // Texel values are sRGB-encoded; averaging them directly darkens every mip
+    float srgbToLinear(unsigned char value)
+    {
+        static const std::vector<float> table = []
+        {
+            std::vector<float> values(256);
+            for (int i = 0; i < 256; ++i)
+            {
+                float c = i / 255.0f;
+                values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            return values;
+        }();
+        return table[value];
+    }
+
+    unsigned char linearToSrgb(float value)
+    {
+        value = std::min(std::max(value, 0.0f), 1.0f);
+        float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        return static_cast<unsigned char>(c * 255.0f + 0.5f);
+    }
+
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> rgba;
+    };
+
+    // Halves an image with a 2x2 box filter (clamped at odd edges). Colors are averaged in
+    // linear light and weighted by alpha; alpha itself is averaged as is.
+    Image downsample(const Image &source)
+    {
+        Image result;
+        result.width = std::max(1, source.width / 2);
+        result.height = std::max(1, source.height / 2);
+        result.rgba.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+        for (int y = 0; y < result.height; ++y)
+        {
+            for (int x = 0; x < result.width; ++x)
+            {
+                float color[3] = {0.0f, 0.0f, 0.0f};
+                float unweighted[3] = {0.0f, 0.0f, 0.0f};
+                float alphaSum = 0.0f;
+                for (int dy = 0; dy < 2; ++dy)
+                {
+                    for (int dx = 0; dx < 2; ++dx)
+                    {
+                        int sx = std::min(x * 2 + dx, source.width - 1);
+                        int sy = std::min(y * 2 + dy, source.height - 1);
+                        const unsigned char *texel = &source.rgba[(static_cast<size_t>(sy) * source.width + sx) * 4];
+                        float alpha = texel[3] / 255.0f;
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            float linear = srgbToLinear(texel[c]);
+                            color[c] += linear * alpha;
+                            unweighted[c] += linear;
+                        }
+                        alphaSum += alpha;
+                    }
+                }
+
+                unsigned char *out = &result.rgba[(static_cast<size_t>(y) * result.width + x) * 4];
+                for (int c = 0; c < 3; ++c)
+                    out[c] = linearToSrgb(alphaSum > 0.0f ? color[c] / alphaSum : unweighted[c] / 4.0f);
+                out[3] = static_cast<unsigned char>(alphaSum / 4.0f * 255.0f + 0.5f);
+            }
+        }
+        return result;
+    }
+
+    // Fraction of texels that pass the alpha test after scaling alpha by 'scale'
+    float alphaCoverage(const Image &image, float scale)
+    {
+        size_t passing = 0;
+        const size_t count = static_cast<size_t>(image.width) * image.height;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (image.rgba[i * 4 + 3] / 255.0f * scale >= kAlphaCutoff)
+                ++passing;
+        }
+        return static_cast<float>(passing) / static_cast<float>(count);
+    }
+
+    // Scales the alpha of a mip so as many of its texels pass the alpha test, proportionally,
+    // as in the top level. Without this, averaging makes alpha drift towards the middle and
+    // cutouts (leaves, grass) lose coverage at every level.
+    void preserveAlphaCoverage(Image &mip, float targetCoverage)
+    {
+        float low = 0.0f;
+        float high = 4.0f;
+        for (int step = 0; step < 10; ++step)
+        {
+            float middle = (low + high) * 0.5f;
+            if (alphaCoverage(mip, middle) > targetCoverage)
+                high = middle;
+            else
+                low = middle;
+        }
+        const float scale = (low + high) * 0.5f;
+        const size_t count = static_cast<size_t>(mip.width) * mip.height;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float alpha = std::min(mip.rgba[i * 4 + 3] * scale, 255.0f);
+            mip.rgba[i * 4 + 3] = static_cast<unsigned char>(alpha + 0.5f);
+        }
+    }
+
+    bool hasTextureStorage()
+    {
+#ifdef __APPLE__
+        return false; // macOS stops at GL 4.1
+#else
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > 4 || (major == 4 && minor >= 2))
+            return true;
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; ++i)
+        {
+            const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+            if (name && std::strcmp(name, "GL_ARB_texture_storage") == 0)
+                return true;
+        }
+        return false;
+#endif
+    }
+}
+
+int TextureArrayBuilder::addLayer(const std::string &path)
+{
+    stbi_set_flip_vertically_on_load(true); // GL expects the bottom row first
+
+    int width = 0, height = 0, channels = 0;
+    unsigned char *data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!data)
+        throw std::runtime_error("Could not load texture " + path + ": " + stbi_failure_reason());
+
+    if (!layers_.empty() && (width != width_ || height != height_))
+    {
+        stbi_image_free(data);
+        throw std::runtime_error("Texture " + path + " is " + std::to_string(width) + "x" + std::to_string(height) + ", but the array's layers are " +
+                                 std::to_string(width_) + "x" + std::to_string(height_) + " (" + layers_.front().path + ")");
+    }
+    width_ = width;
+    height_ = height;
+
+    Layer layer;
+    layer.path = path;
+    layer.rgba.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+    for (size_t i = 3; i < layer.rgba.size() && !layer.cutout; i += 4)
+        layer.cutout = layer.rgba[i] < 255;
+
+    layers_.push_back(std::move(layer));
+    return static_cast<int>(layers_.size()) - 1;
+}
+
+int TextureArrayBuilder::getLevelCount() const
+{
+    int levels = 1;
+    for (int size = std::max(width_, height_); size > 1; size /= 2)
+        ++levels;
+    return levels;
+}
+
+unsigned int TextureArrayBuilder::build() const
+{
+    if (layers_.empty())
+        throw std::runtime_error("Texture array has no layers.");
+
+    GLint maxLayers = 0, maxSize = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (getLayerCount() > maxLayers || width_ > maxSize || height_ > maxSize)
+    {
+        throw std::runtime_error("Texture array of " + std::to_string(getLayerCount()) + " layers of " + std::to_string(width_) + "x" +
+                                 std::to_string(height_) + " exceeds the GL limits (" + std::to_string(maxLayers) + " layers, " +
+                                 std::to_string(maxSize) + " texels)");
+    }
+
+    const int levelCount = getLevelCount();
+    unsigned int texture = 0;
+    glGenTextures(1, &texture);
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, texture);
+
+    const bool immutable = hasTextureStorage();
+#ifndef __APPLE__
+    if (immutable)
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, levelCount, GL_RGBA8, width_, height_, getLayerCount());
+#endif
+    if (!immutable)
+    {
+        // Same levels as glTexStorage3D would allocate, but mutable
+        for (int level = 0; level < levelCount; ++level)
+        {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(1, width_ >> level), std::max(1, height_ >> level),
+                         getLayerCount(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    }
+
+    // One upload per layer and level, each mip made from the previous one
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int layerIndex = 0; layerIndex < getLayerCount(); ++layerIndex)
+    {
+        const Layer &layer = layers_[layerIndex];
+        Image mip{width_, height_, layer.rgba};
+        const float coverage = layer.cutout ? alphaCoverage(mip, 1.0f) : 0.0f;
+        for (int level = 0; level < levelCount; ++level)
+        {
+            if (level > 0)
+            {
+                mip = downsample(mip);
+                if (layer.cutout)
+                    preserveAlphaCoverage(mip, coverage);
+            }
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layerIndex, mip.width, mip.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, mip.rgba.data());
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    std::cout << "Texture array: " << getLayerCount() << " layers of " << width_ << "x" << height_ << ", " << levelCount << " mip levels, RGBA8"
+              << (immutable ? " (immutable storage)." : ".") << std::endl;
+    return texture;
+}
@@ -1,5 +1,5 @@
 #include "Window.h"
-#include <OpenGL/gl.h>
+#include "GLPlatform.h"
 #include <cstddef>
 #include <stdexcept> // For runtime_error
 #include <iostream>  // For cerr
@@ -8,10 +8,6 @@
 #include <GLFW/glfw3.h>
 #include <string>
 
-#ifdef __APPLE__
-#include <OpenGL/gl3.h> // Or Glad/GLEW if you switch
-#endif
-
 Window::Window(int width, int height, const std::string &title, bool isVSyncEnabled)
     : width_(width), height_(height), title_(title), isVSyncEnabled_(isVSyncEnabled)
 {
@@ -1,4 +1,6 @@
 #include "World.h"
+#include <algorithm>
+#include <cstring>
 // #include <iostream> // Already included via World.h indirectly
 
 // --- getIndex implementation (from your provided code) ---
@@ -15,7 +17,7 @@ int World::getIndex(int x, int y, int z) const
 }
 
 // --- Constructor (from your provided code) ---
-World::World() : blocks(WORLD_VOLUME, BlockType::AIR) {}
+World::World() : blocks(WORLD_VOLUME, BlockType::AIR), dirtyChunks(CHUNK_COUNT, 1) {}
 
 // --- addBlock (from your provided code) ---
 void World::addBlock(int x, int y, int z, BlockType blockType)
@@ -24,6 +26,7 @@ void World::addBlock(int x, int y, int z, BlockType blockType)
     if (index != -1)
     {
         blocks[index] = blockType;
+        markRegionDirty(glm::ivec3(x, y, z), glm::ivec3(x, y, z));
     }
 }
 
@@ -34,6 +37,7 @@ void World::removeBlock(int x, int y, int z)
     if (index != -1)
     {
         blocks[index] = BlockType::AIR;
+        markRegionDirty(glm::ivec3(x, y, z), glm::ivec3(x, y, z));
     }
 }
 
@@ -60,4 +64,170 @@ bool World::isSolid(int x, int y, int z) const
     }
     // Check if the block value is not AIR
     return blocks[index] != BlockType::AIR;
-}
\ No newline at end of file
+}
+
+void World::isSolidBatch(const int *xs, const int *ys, const int *zs, uint8_t *out, size_t count) const
+{
+    const BlockType *data = blocks.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Unsigned compares fold the "< 0" checks in; out-of-bounds reads are redirected to index 0
+        bool inside = (static_cast<unsigned>(xs[i]) < static_cast<unsigned>(WORLD_WIDTH)) &
+                      (static_cast<unsigned>(ys[i]) < static_cast<unsigned>(WORLD_HEIGHT)) &
+                      (static_cast<unsigned>(zs[i]) < static_cast<unsigned>(WORLD_DEPTH));
+        int index = inside ? ys[i] * (WORLD_DEPTH * WORLD_WIDTH) + zs[i] * WORLD_WIDTH + xs[i] : 0;
+        out[i] = static_cast<uint8_t>(inside & (data[index] != BlockType::AIR));
+    }
+}
+
+void World::anySolidBatch(const int *x0s, const int *x1s, const int *ys, const int *z0s, const int *z1s, uint8_t *out, size_t count) const
+{
+    const BlockType *data = blocks.data();
+    auto solidAt = [data](int x, int y, int z)
+    {
+        // Same redirect of out-of-bounds reads as isSolidBatch
+        bool inside = (static_cast<unsigned>(x) < static_cast<unsigned>(WORLD_WIDTH)) &
+                      (static_cast<unsigned>(y) < static_cast<unsigned>(WORLD_HEIGHT)) &
+                      (static_cast<unsigned>(z) < static_cast<unsigned>(WORLD_DEPTH));
+        int index = inside ? y * (WORLD_DEPTH * WORLD_WIDTH) + z * WORLD_WIDTH + x : 0;
+        return static_cast<uint8_t>(inside & (data[index] != BlockType::AIR));
+    };
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = solidAt(x0s[i], ys[i], z0s[i]) | solidAt(x1s[i], ys[i], z0s[i]) |
+                 solidAt(x0s[i], ys[i], z1s[i]) | solidAt(x1s[i], ys[i], z1s[i]);
+    }
+}
+
+bool World::clipRegion(glm::ivec3 &min, glm::ivec3 &max)
+{
+    min = glm::max(min, glm::ivec3(0));
+    max = glm::min(max, glm::ivec3(WORLD_WIDTH - 1, WORLD_HEIGHT - 1, WORLD_DEPTH - 1));
+    return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+}
+
+void World::markRegionDirty(const glm::ivec3 &min, const glm::ivec3 &max)
+{
+    glm::ivec3 chunkMin = min / CHUNK_SIZE;
+    glm::ivec3 chunkMax = max / CHUNK_SIZE;
+    for (int cy = chunkMin.y; cy <= chunkMax.y; ++cy)
+        for (int cz = chunkMin.z; cz <= chunkMax.z; ++cz)
+            for (int cx = chunkMin.x; cx <= chunkMax.x; ++cx)
+                dirtyChunks[(cy * CHUNKS_Z + cz) * CHUNKS_X + cx] = 1;
+}
+
+void World::fillRegion(const glm::ivec3 &min, const glm::ivec3 &max, BlockType type)
+{
+    glm::ivec3 lo = min, hi = max;
+    if (!clipRegion(lo, hi))
+        return;
+
+    // Rows along X are contiguous in memory, and BlockType is one byte, so each row is a memset
+    size_t rowLength = static_cast<size_t>(hi.x - lo.x + 1);
+    for (int y = lo.y; y <= hi.y; ++y)
+        for (int z = lo.z; z <= hi.z; ++z)
+            std::memset(&blocks[getIndex(lo.x, y, z)], static_cast<int>(type), rowLength);
+
+    markRegionDirty(lo, hi);
+}
+
+void World::replaceInRegion(const glm::ivec3 &min, const glm::ivec3 &max, BlockType from, BlockType to)
+{
+    glm::ivec3 lo = min, hi = max;
+    if (!clipRegion(lo, hi))
+        return;
+
+    int rowLength = hi.x - lo.x + 1;
+    for (int y = lo.y; y <= hi.y; ++y)
+    {
+        for (int z = lo.z; z <= hi.z; ++z)
+        {
+            // Select instead of branch so the compiler turns the row into byte-wise SIMD compares
+            BlockType *row = &blocks[getIndex(lo.x, y, z)];
+            for (int i = 0; i < rowLength; ++i)
+                row[i] = (row[i] == from) ? to : row[i];
+        }
+    }
+
+    markRegionDirty(lo, hi);
+}
+
+BlockRegion World::copyRegion(const glm::ivec3 &min, const glm::ivec3 &max) const
+{
+    BlockRegion region;
+    glm::ivec3 lo = min, hi = max;
+    if (!clipRegion(lo, hi))
+        return region;
+
+    region.size = hi - lo + 1;
+    region.blocks.resize(static_cast<size_t>(region.size.x) * region.size.y * region.size.z);
+
+    BlockType *dst = region.blocks.data();
+    for (int y = lo.y; y <= hi.y; ++y)
+    {
+        for (int z = lo.z; z <= hi.z; ++z)
+        {
+            std::memcpy(dst, &blocks[getIndex(lo.x, y, z)], region.size.x);
+            dst += region.size.x;
+        }
+    }
+    return region;
+}
+
+void World::pasteRegion(const BlockRegion &region, const glm::ivec3 &origin, bool skipAir)
+{
+    glm::ivec3 lo = origin, hi = origin + region.size - 1;
+    if (region.blocks.empty() || !clipRegion(lo, hi))
+        return;
+
+    int rowLength = hi.x - lo.x + 1;
+    for (int y = lo.y; y <= hi.y; ++y)
+    {
+        for (int z = lo.z; z <= hi.z; ++z)
+        {
+            // Source row, offset by whatever part of the region was clipped away
+            glm::ivec3 src = glm::ivec3(lo.x, y, z) - origin;
+            const BlockType *srcRow = &region.blocks[(static_cast<size_t>(src.y) * region.size.z + src.z) * region.size.x + src.x];
+            BlockType *dstRow = &blocks[getIndex(lo.x, y, z)];
+
+            if (!skipAir)
+            {
+                std::memcpy(dstRow, srcRow, rowLength);
+            }
+            else
+            {
+                for (int i = 0; i < rowLength; ++i)
+                    dstRow[i] = (srcRow[i] == BlockType::AIR) ? dstRow[i] : srcRow[i];
+            }
+        }
+    }
+
+    markRegionDirty(lo, hi);
+}
+
+bool World::isChunkDirty(int cx, int cy, int cz) const
+{
+    if (cx < 0 || cx >= CHUNKS_X || cy < 0 || cy >= CHUNKS_Y || cz < 0 || cz >= CHUNKS_Z)
+        return false;
+    return dirtyChunks[(cy * CHUNKS_Z + cz) * CHUNKS_X + cx] != 0;
+}
+
+bool World::hasDirtyChunks() const
+{
+    for (uint8_t dirty : dirtyChunks)
+        if (dirty)
+            return true;
+    return false;
+}
+
+void World::clearChunkDirty(int cx, int cy, int cz)
+{
+    if (cx < 0 || cx >= CHUNKS_X || cy < 0 || cy >= CHUNKS_Y || cz < 0 || cz >= CHUNKS_Z)
+        return;
+    dirtyChunks[(cy * CHUNKS_Z + cz) * CHUNKS_X + cx] = 0;
+}
+
+void World::clearDirtyChunks()
+{
+    std::fill(dirtyChunks.begin(), dirtyChunks.end(), 0);
+}
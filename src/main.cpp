@@ -1,11 +1,179 @@
 #include "Application.h"
 #include <exception>
 #include <iostream>
+#include <string>
 #include <cstdlib> // For EXIT_SUCCESS, EXIT_FAILURE
 
-int main()
+namespace
 {
-    Application app;
+    void printUsage(const char *program)
+    {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --record <file>     Record input to <file> for later replay\n"
+                  << "  --replay <file>     Replay input recorded with --record, then exit\n"
+                  << "  --stats-out <file>  Frame stats file (.csv or .json, default frame_stats.csv, '' to disable)\n"
+                  << "  --shader-cache <dir>  Program binary cache (default shader_cache, '' to disable)\n"
+                  << "  --no-shader-watch   Do not reload shaders when their files change\n"
+                  << "  --headless          Render offscreen without a window (needs a HEADLESS=1 build)\n"
+                  << "  --frames <n>        Exit after rendering <n> frames\n"
+                  << "  --software          Rasterize on the CPU instead of the GPU\n"
+                  << "  --vertex-pulling    Draw chunks from 8-byte face records instead of vertex buffers\n"
+                  << "  --golden <dir>      Render the golden-image cases, compare them with <dir>, then exit\n"
+                  << "  --update-golden <dir>  Render the golden-image cases and overwrite the images in <dir>\n"
+                  << "  --lod-distance <n>  Chunks closer than <n> blocks get full detail, doubling per LOD (default 16)\n"
+                  << "  --hitch-thresholds <ms,ms,...>  Frame times counted as hitches (default 33.3,50,100)\n"
+                  << "  --help              Show this message" << std::endl;
+    }
+
+    enum class ParseResult
+    {
+        Run,       // Options are valid, start the app
+        HelpShown, // --help printed the usage, exit successfully
+        Invalid    // Unknown or incomplete options (already reported), exit with an error
+    };
+
+    ParseResult parseArguments(int argc, char **argv, AppConfig &config)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--headless")
+            {
+                config.headless = true;
+                continue;
+            }
+            if (arg == "--software")
+            {
+                config.softwareRenderer = true;
+                continue;
+            }
+            if (arg == "--vertex-pulling")
+            {
+                config.vertexPulling = true;
+                continue;
+            }
+            if (arg == "--no-shader-watch")
+            {
+                config.watchShaders = false;
+                continue;
+            }
+
+            std::string *value = nullptr;
+            std::string frames;
+            std::string lodDistance;
+            std::string hitchThresholds;
+            if (arg == "--record")
+                value = &config.recordInputPath;
+            else if (arg == "--replay")
+                value = &config.replayInputPath;
+            else if (arg == "--stats-out")
+                value = &config.frameStatsPath;
+            else if (arg == "--shader-cache")
+                value = &config.shaderCacheDir;
+            else if (arg == "--frames")
+                value = &frames;
+            else if (arg == "--lod-distance")
+                value = &lodDistance;
+            else if (arg == "--hitch-thresholds")
+                value = &hitchThresholds;
+            else if (arg == "--golden" || arg == "--update-golden")
+            {
+                value = &config.goldenDir;
+                config.updateGolden = (arg == "--update-golden");
+            }
+            else if (arg == "--help" || arg == "-h")
+            {
+                printUsage(argv[0]);
+                return ParseResult::HelpShown;
+            }
+            else
+            {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                printUsage(argv[0]);
+                return ParseResult::Invalid;
+            }
+
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return ParseResult::Invalid;
+            }
+            *value = argv[++i];
+
+            if (value == &frames)
+            {
+                config.maxFrames = std::atoi(frames.c_str());
+                if (config.maxFrames <= 0)
+                {
+                    std::cerr << "--frames needs a positive frame count" << std::endl;
+                    return ParseResult::Invalid;
+                }
+            }
+            else if (value == &lodDistance)
+            {
+                config.lodDistance = static_cast<float>(std::atof(lodDistance.c_str()));
+                if (config.lodDistance <= 0.0f)
+                {
+                    std::cerr << "--lod-distance needs a positive distance" << std::endl;
+                    return ParseResult::Invalid;
+                }
+            }
+            else if (value == &hitchThresholds)
+            {
+                // Comma-separated milliseconds, e.g. 33.3,50,100
+                config.hitchThresholdsMs.clear();
+                size_t start = 0;
+                while (start <= hitchThresholds.size())
+                {
+                    size_t end = hitchThresholds.find(',', start);
+                    if (end == std::string::npos)
+                        end = hitchThresholds.size();
+                    const double thresholdMs = std::atof(hitchThresholds.substr(start, end - start).c_str());
+                    if (thresholdMs <= 0.0)
+                    {
+                        std::cerr << "--hitch-thresholds needs a comma-separated list of positive times in ms" << std::endl;
+                        return ParseResult::Invalid;
+                    }
+                    config.hitchThresholdsMs.push_back(thresholdMs);
+                    start = end + 1;
+                }
+            }
+        }
+
+        if (!config.recordInputPath.empty() && !config.replayInputPath.empty())
+        {
+            std::cerr << "--record and --replay cannot be combined." << std::endl;
+            return ParseResult::Invalid;
+        }
+        if (config.softwareRenderer && config.vertexPulling)
+        {
+            std::cerr << "--software and --vertex-pulling cannot be combined." << std::endl;
+            return ParseResult::Invalid;
+        }
+        // Nothing can close a headless run, so it must have an end
+        if (config.headless && config.maxFrames == 0 && config.replayInputPath.empty() && config.goldenDir.empty())
+        {
+            std::cerr << "--headless needs --frames, --replay or --golden to know when to stop." << std::endl;
+            return ParseResult::Invalid;
+        }
+        return ParseResult::Run;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    AppConfig config;
+    switch (parseArguments(argc, argv, config))
+    {
+    case ParseResult::Run:
+        break;
+    case ParseResult::HelpShown:
+        return EXIT_SUCCESS;
+    case ParseResult::Invalid:
+        return EXIT_FAILURE;
+    }
+
+    Application app(config);
 
     try
     {
@@ -14,6 +182,8 @@ int main()
             std::cerr << "Application failed to initialize!" << std::endl;
             return EXIT_FAILURE; // Indicate failure
         }
+        if (!config.goldenDir.empty())
+            return app.runGoldenImages() ? EXIT_SUCCESS : EXIT_FAILURE;
         app.run(); // Start the main loop
     }
     catch (const std::exception &e)
@@ -30,4 +200,4 @@ int main()
     }
 
     return EXIT_SUCCESS; // Indicate successful execution
-}
\ No newline at end of file
+}
@@ -0,0 +1,63 @@
+// Checks that entity collision uses the whole bounding box: a box whose center hangs over
+// the edge of a block still lands on it, and a box moving into a wall stops with its face
+// against the wall instead of its center.
+
+#include "EntityManager.h"
+#include "World.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+    const float kDt = 1.0f / 60.0f;
+    const float kHalf = 0.25f;
+
+    bool near(float a, float b) { return std::abs(a - b) < 1e-3f; }
+
+    void tick(EntityManager &entities, const World &world, int ticks)
+    {
+        for (int i = 0; i < ticks; ++i)
+            entities.update(world, kDt);
+    }
+}
+
+int main()
+{
+    // Ledge: one block at (4, 4, 4) with nothing around it
+    {
+        World world;
+        world.addBlock(4, 4, 4, BlockType::STONE);
+        EntityManager entities;
+        // Center over x = 5.1 (air), but the box reaches back to 4.85, over the block
+        Entity entity = entities.create(EntityKind::DROPPED_ITEM, glm::vec3(5.1f, 7.0f, 4.5f), glm::vec3(0.0f), glm::vec3(kHalf));
+        tick(entities, world, 120);
+        glm::vec3 position = entities.getPosition(entity);
+        if (!entities.isAlive(entity) || !near(position.y, 5.0f + kHalf))
+        {
+            std::cerr << "FAIL: a box overhanging a ledge did not land on it (y " << position.y << ")." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Wall: floor at y = 0 and a wall at x = 8, the box slides towards it along +x
+    {
+        World world;
+        world.fillRegion(glm::ivec3(0, 0, 0), glm::ivec3(WORLD_WIDTH - 1, 0, WORLD_DEPTH - 1), BlockType::STONE);
+        world.fillRegion(glm::ivec3(8, 1, 0), glm::ivec3(8, 3, WORLD_DEPTH - 1), BlockType::STONE);
+        EntityManager entities;
+        entities.groundFriction = 0.0f;
+        Entity entity = entities.create(EntityKind::DROPPED_ITEM, glm::vec3(4.5f, 1.0f + kHalf, 4.5f), glm::vec3(6.0f, 0.0f, 0.0f), glm::vec3(kHalf));
+        tick(entities, world, 120);
+        glm::vec3 position = entities.getPosition(entity);
+        if (!near(position.x, 8.0f - kHalf) || !near(position.y, 1.0f + kHalf))
+        {
+            std::cerr << "FAIL: a box sliding into a wall ended at x " << position.x << ", y " << position.y << " (expected x " << 8.0f - kHalf << ")." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "PASS: boxes land on ledges they overhang and stop with their face against walls." << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+// Checks that entity handles never come back to life: one slot is destroyed and recreated
+// past the point where its 8-bit generation would wrap, and every earlier handle must stay
+// dead while INVALID_ENTITY is never handed out.
+
+#include "EntityManager.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+    EntityManager entities;
+    std::vector<Entity> destroyed;
+    for (int cycle = 0; cycle < 1000; ++cycle)
+    {
+        Entity entity = entities.create(EntityKind::DROPPED_ITEM, glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.125f));
+        if (entity == INVALID_ENTITY || !entities.isAlive(entity))
+        {
+            std::cerr << "FAIL: create() returned an unusable handle in cycle " << cycle << "." << std::endl;
+            return EXIT_FAILURE;
+        }
+        for (Entity old : destroyed)
+        {
+            if (old == entity || entities.isAlive(old))
+            {
+                std::cerr << "FAIL: handle " << old << " of a destroyed entity is alive again in cycle " << cycle << "." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        entities.destroy(entity);
+        destroyed.push_back(entity);
+    }
+    std::cout << "PASS: " << destroyed.size() << " create/destroy cycles, no stale handle became valid." << std::endl;
+    return EXIT_SUCCESS;
+}
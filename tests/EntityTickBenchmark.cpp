@@ -0,0 +1,75 @@
+// Ticks 100k entities in a small world and reports the time per tick on one core (the
+// entity systems are single-threaded). The target is well under a millisecond per tick.
+// Also checks that the tick is right: every entity that started above the floor must end
+// up resting on it, none below it.
+
+#include "EntityManager.h"
+#include "World.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t kEntityCount = 100000;
+    const int kTicks = 300; // 5 seconds of simulation: the falling phase, then resting
+    const float kDt = 1.0f / 60.0f;
+}
+
+int main()
+{
+    World world;
+    world.fillRegion(glm::ivec3(0, 0, 0), glm::ivec3(WORLD_WIDTH - 1, 0, WORLD_DEPTH - 1), BlockType::STONE);
+
+    // Dropped items and mobs spread over the world, some already moving sideways
+    EntityManager entities;
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> horizontal(3.0f, static_cast<float>(WORLD_WIDTH) - 3.0f);
+    std::uniform_real_distribution<float> height(2.0f, static_cast<float>(WORLD_HEIGHT) - 2.0f);
+    std::uniform_real_distribution<float> speed(-1.0f, 1.0f);
+    for (size_t i = 0; i < kEntityCount; ++i)
+    {
+        const bool mob = i % 8 == 0;
+        const glm::vec3 halfExtents = mob ? glm::vec3(0.3f, 0.9f, 0.3f) : glm::vec3(0.125f);
+        entities.create(mob ? EntityKind::MOB : EntityKind::DROPPED_ITEM, glm::vec3(horizontal(random), height(random), horizontal(random)),
+                        glm::vec3(speed(random), 0.0f, speed(random)), halfExtents);
+    }
+
+    std::vector<double> tickMs;
+    tickMs.reserve(kTicks);
+    for (int tick = 0; tick < kTicks; ++tick)
+    {
+        auto start = std::chrono::steady_clock::now();
+        entities.update(world, kDt);
+        tickMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    const EntityComponents &c = entities.components();
+    if (c.size() != kEntityCount)
+    {
+        std::cerr << "FAIL: " << kEntityCount - c.size() << " entities fell out of the world." << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < c.size(); ++i)
+    {
+        const float restY = 1.0f + c.halfY[i];
+        if (std::abs(c.posY[i] - restY) > 1e-3f || c.velY[i] != 0.0f)
+        {
+            std::cerr << "FAIL: entity " << i << " is at y " << c.posY[i] << " moving " << c.velY[i] << ", expected resting at " << restY << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<double> sorted = tickMs;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double ms : tickMs)
+        total += ms;
+    std::cout << "PASS: " << kEntityCount << " entities, " << total / kTicks << " ms/tick mean, " << sorted[sorted.size() / 2]
+              << " median, " << sorted.back() << " max over " << kTicks << " ticks (target: under 1 ms)." << std::endl;
+    return EXIT_SUCCESS;
+}
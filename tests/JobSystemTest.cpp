@@ -0,0 +1,55 @@
+// Checks that a job that throws still counts as finished: wait() must return (rather than
+// spin forever on a counter that never reaches zero) and rethrow the job's exception, and
+// the JobSystem must keep working afterwards.
+
+#include "JobSystem.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main()
+{
+    JobSystem jobs(4);
+    const size_t kRanges = 64;
+
+    std::atomic<size_t> rangesRun{0};
+    std::string message;
+    try
+    {
+        jobs.parallelFor(kRanges, 1, [&](size_t begin, size_t)
+                         {
+                             ++rangesRun;
+                             if (begin == kRanges / 2)
+                                 throw std::runtime_error("job failed");
+                         });
+    }
+    catch (const std::runtime_error &e)
+    {
+        message = e.what();
+    }
+
+    if (message != "job failed")
+    {
+        std::cerr << "FAIL: wait() did not rethrow the job's exception." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (rangesRun.load() != kRanges)
+    {
+        std::cerr << "FAIL: " << rangesRun.load() << " of " << kRanges << " ranges ran before wait() returned." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::atomic<size_t> after{0};
+    jobs.parallelFor(kRanges, 1, [&](size_t, size_t)
+                     { ++after; });
+    if (after.load() != kRanges)
+    {
+        std::cerr << "FAIL: the job system stopped running jobs after an exception." << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "PASS: a throwing job finished its counter and wait() rethrew \"" << message << "\"." << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+// Checks that re-meshing a dirty chunk does not touch the heap once the arenas and staging
+// buffers have grown to fit (the steady state Application::rebuildChunkMesh relies on).
+// Global operator new is replaced with a counting version; the test fails if any allocation
+// happens during the measured re-meshes.
+
+#include "Application.h" // FaceToLayer
+#include "Arena.h"
+#include "MeshBuilder.h"
+#include "MeshData.h"
+#include "World.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <vector>
+
+namespace
+{
+    std::atomic<size_t> allocationCount{0};
+}
+
+void *operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+    const int kChunk = 0;       // Chunk (0, 0, 0) is re-meshed
+    const int kWarmupRuns = 4;  // Lets the arena merge its blocks and the buffers reach capacity
+    const int kMeasuredRuns = 100;
+
+    // What one chunk keeps between rebuilds (ChunkMesh in Application.h)
+    struct ChunkState
+    {
+        MeshData cpuMesh;                          // Software renderer path
+        std::vector<PackedVertex> stagingVertices; // GL path
+    };
+
+    // Mirrors Application::rebuildChunkMesh for both backends (without the GL upload)
+    void remeshChunk(const World &world, int lod, Arena &arena, ChunkState &chunk, const std::map<BlockType, FaceToLayer> &layers)
+    {
+        {
+            ArenaScope scope(arena);
+            ArenaMeshData meshData(arena);
+            MeshBuilder::generateChunkMesh(world, kChunk, kChunk, kChunk, lod, meshData, layers);
+            chunk.cpuMesh.assign(meshData);
+        }
+
+        MeshBuilder::ChunkCells cells;
+        MeshBuilder::classifyChunk(world, kChunk, kChunk, kChunk, lod, cells);
+        chunk.stagingVertices.resize(cells.vertexCount());
+        PackedMeshWriter writer(chunk.stagingVertices.data());
+        MeshBuilder::emitChunkCells(cells, writer, layers);
+    }
+
+    // One frame: an edit dirties the chunk, then it is re-meshed at both LODs
+    void runFrame(World &world, int frame, Arena &arena, ChunkState &chunk, const std::map<BlockType, FaceToLayer> &layers)
+    {
+        arena.reset(); // Frame lifetime, like updateChunkMeshes
+        if (frame % 2 == 0)
+            world.addBlock(5, 9, 5, BlockType::STONE);
+        else
+            world.removeBlock(5, 9, 5);
+        for (int lod = 0; lod < 2; ++lod)
+            remeshChunk(world, lod, arena, chunk, layers);
+        world.clearChunkDirty(kChunk, kChunk, kChunk);
+    }
+}
+
+int main()
+{
+    World world;
+    world.fillRegion(glm::ivec3(0, 0, 0), glm::ivec3(CHUNK_SIZE - 1, 7, CHUNK_SIZE - 1), BlockType::STONE);
+    world.fillRegion(glm::ivec3(2, 8, 2), glm::ivec3(9, 8, 9), BlockType::GRASS);
+
+    std::map<BlockType, FaceToLayer> layers;
+    for (int type = static_cast<int>(BlockType::DIRT); type <= static_cast<int>(BlockType::OAK_LEAF); ++type)
+        layers.emplace(static_cast<BlockType>(type), FaceToLayer{type, type, type, type, type, type});
+
+    Arena arena;
+    ChunkState chunk;
+    int frame = 0;
+    for (; frame < kWarmupRuns; ++frame)
+        runFrame(world, frame, arena, chunk, layers);
+
+    const size_t before = allocationCount.load();
+    for (int run = 0; run < kMeasuredRuns; ++run, ++frame)
+        runFrame(world, frame, arena, chunk, layers);
+    const size_t allocations = allocationCount.load() - before;
+
+    if (chunk.stagingVertices.empty() || chunk.cpuMesh.vertices.empty())
+    {
+        std::cerr << "FAIL: the test chunk produced no geometry." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (allocations != 0)
+    {
+        std::cerr << "FAIL: " << allocations << " heap allocations in " << kMeasuredRuns << " steady-state chunk re-meshes (expected 0)." << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "PASS: " << kMeasuredRuns << " chunk re-meshes, 0 heap allocations (arena peak " << arena.peakBytes() << " bytes)." << std::endl;
+    return EXIT_SUCCESS;
+}